@@ -0,0 +1,68 @@
+# Sources communes à l'application et aux bancs de mesure (bench)
+
+SOURCES += \
+        $$PWD/src/gui/BranchWindow.cpp \
+        $$PWD/src/gui/ErrorViewer.cpp \
+        $$PWD/src/gui/FetchWindow.cpp \
+        $$PWD/src/gui/MainWindow.cpp \
+        $$PWD/src/gui/OutputViewer.cpp \
+        $$PWD/src/gui/PerfDock.cpp \
+        $$PWD/src/gui/TagsWindow.cpp \
+        $$PWD/src/gui/WorkspaceDock.cpp \
+        $$PWD/src/tools/Context.cpp \
+        $$PWD/src/tools/GitExecutor.cpp \
+        $$PWD/src/tools/IndexReader.cpp \
+        $$PWD/src/tools/Logger.cpp \
+        $$PWD/src/tools/RefReader.cpp \
+        $$PWD/src/tools/RefreshCoalescer.cpp \
+        $$PWD/src/tools/RefService.cpp \
+        $$PWD/src/tools/RefSnapshot.cpp \
+        $$PWD/src/tools/RepoFingerprint.cpp \
+        $$PWD/src/tools/RepoLocator.cpp \
+        $$PWD/src/tools/RepoWatcher.cpp \
+        $$PWD/src/tools/StagedIndex.cpp \
+        $$PWD/src/tools/StatusCache.cpp \
+        $$PWD/src/tools/StatusModel.cpp \
+        $$PWD/src/tools/StatusParser.cpp \
+        $$PWD/src/tools/Tracer.cpp \
+        $$PWD/src/tools/Workspace.cpp
+
+HEADERS += \
+        $$PWD/inc/gui/BranchWindow.hpp \
+        $$PWD/inc/gui/ErrorViewer.hpp \
+        $$PWD/inc/gui/FetchWindow.hpp \
+        $$PWD/inc/gui/MainWindow.hpp \
+        $$PWD/inc/gui/OutputViewer.hpp \
+        $$PWD/inc/gui/PerfDock.hpp \
+        $$PWD/inc/gui/TagsWindow.hpp \
+        $$PWD/inc/gui/WorkspaceDock.hpp \
+        $$PWD/inc/tools/Context.hpp \
+        $$PWD/inc/tools/GitExecutor.hpp \
+        $$PWD/inc/tools/IndexReader.hpp \
+        $$PWD/inc/tools/Logger.hpp \
+        $$PWD/inc/tools/RefReader.hpp \
+        $$PWD/inc/tools/RefreshCoalescer.hpp \
+        $$PWD/inc/tools/RefService.hpp \
+        $$PWD/inc/tools/RefSnapshot.hpp \
+        $$PWD/inc/tools/RepoFingerprint.hpp \
+        $$PWD/inc/tools/RepoLocator.hpp \
+        $$PWD/inc/tools/RepoWatcher.hpp \
+        $$PWD/inc/tools/StagedIndex.hpp \
+        $$PWD/inc/tools/StatusCache.hpp \
+        $$PWD/inc/tools/StatusModel.hpp \
+        $$PWD/inc/tools/StatusParser.hpp \
+        $$PWD/inc/tools/Tracer.hpp \
+        $$PWD/inc/tools/Workspace.hpp
+
+INCLUDEPATH += $$PWD/inc/gui \
+        $$PWD/inc/tools
+
+FORMS += \
+        $$PWD/form/BranchWindow.ui \
+        $$PWD/form/ErrorViewer.ui \
+        $$PWD/form/FetchWindow.ui \
+        $$PWD/form/MainWindow.ui \
+        $$PWD/form/OutputViewer.ui \
+        $$PWD/form/PerfDock.ui \
+        $$PWD/form/TagsWindow.ui \
+        $$PWD/form/WorkspaceDock.ui
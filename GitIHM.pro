@@ -7,31 +7,10 @@ CONFIG += c++11
 
 DESTDIR = ./../build
 
-SOURCES += \
-        src/gui/BranchWindow.cpp \
-        src/gui/ErrorViewer.cpp \
-        src/gui/TagsWindow.cpp \
-        src/main.cpp \
-        src/gui/MainWindow.cpp \
-        src/tools/Context.cpp \
-        src/tools/Logger.cpp
-
-HEADERS += \
-        inc/gui/BranchWindow.hpp \
-        inc/gui/ErrorViewer.hpp \
-        inc/gui/MainWindow.hpp \
-        inc/gui/TagsWindow.hpp \
-        inc/tools/Context.hpp \
-        inc/tools/Logger.hpp
+include(GitIHM.pri)
 
-INCLUDEPATH += inc/gui \
-        inc/tools
-
-FORMS += \
-        form/BranchWindow.ui \
-        form/ErrorViewer.ui \
-        form/MainWindow.ui \
-        form/TagsWindow.ui
+SOURCES += \
+        src/main.cpp
 
 RESOURCES += \
     ressources/darkstyle.qrc
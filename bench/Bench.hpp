@@ -0,0 +1,57 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+    #include <QElapsedTimer>
+    #include <QString>
+    #include <QVector>
+
+    #include "RepoGenerator.hpp"
+
+    /**
+     * @struct BenchResult
+     * @brief Résultat d'une mesure de performance.
+     */
+    struct BenchResult
+    {
+        QString name;/**< Nom de la mesure */
+        int iterations;/**< Nombre d'itérations */
+        qint64 totalNs;/**< Durée totale (ns) */
+
+        qint64 perIteration() const { return iterations > 0 ? totalNs / iterations : 0; }
+    };
+
+    extern volatile qint64 g_benchSink;/**< Puits empêchant l'optimisation des calculs mesurés */
+
+    /**
+     * @param name Nom de la mesure
+     * @param iterations Nombre d'itérations
+     * @param func Fonction mesurée, elle renvoie une valeur dépendant de son calcul
+     * @return Résultat de la mesure
+     */
+    template<class Func> BenchResult measure(const QString& name, int iterations, Func func)
+    {
+        qint64 sink = 0;
+        QElapsedTimer clock;
+        clock.start();
+        for(int i = 0; i < iterations; i++)
+        {
+            sink += func();
+        }
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.totalNs = clock.nsecsElapsed();
+        g_benchSink = g_benchSink + sink;
+        return result;
+    }
+
+    void report(const BenchResult& result);
+    const QVector<BenchResult>& results();
+
+    // Mesures
+    void benchStatusParser(int entries);
+    void benchIndexReader(int entries);
+    void benchLogger(int iterations);
+    bool benchGui(const RepoSpec& spec, int iterations);
+
+#endif // BENCH_HPP
@@ -0,0 +1,23 @@
+QT       += core gui widgets
+
+TARGET = GitIHMBench
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DESTDIR = ./../../build
+
+include(../GitIHM.pri)
+
+SOURCES += \
+        main.cpp \
+        GuiBench.cpp \
+        IndexReaderBench.cpp \
+        LoggerBench.cpp \
+        RepoGenerator.cpp \
+        StatusParserBench.cpp
+
+HEADERS += \
+        Bench.hpp \
+        RepoGenerator.hpp
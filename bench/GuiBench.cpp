@@ -0,0 +1,142 @@
+#include "Bench.hpp"
+
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QTextStream>
+
+#include "BranchWindow.hpp"
+#include "Context.hpp"
+#include "MainWindow.hpp"
+#include "RefReader.hpp"
+#include "TagsWindow.hpp"
+
+#define WAIT_TIMEOUT_MS     600000  /**< Attente maximale d'une mise à jour */
+#define BENCH_PROCESS_POOL  3       /**< Nombre de processus Git, fixe pour des mesures comparables */
+
+/**
+ * @param sender Objet émetteur
+ * @param signal Signal attendu
+ * @return @c false si le délai #WAIT_TIMEOUT_MS est dépassé
+ *
+ * Exécute la boucle d'événements jusqu'à l'émission du signal.
+ */
+template<class Sender, class Signal> static bool waitFor(Sender* sender, Signal signal)
+{
+    QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    QObject::connect(sender, signal, &loop, &QEventLoop::quit);
+    QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    timeout.start(WAIT_TIMEOUT_MS);
+    loop.exec();
+    return timeout.isActive();
+}
+
+/**
+ * @param window Fenêtre principale
+ * @param slot Connecteur de mise à jour renvoyant un GitJob*
+ * @return 1 si une commande a été lancée, 0 sinon
+ *
+ * Appelle un connecteur privé de la fenêtre et attend la fin de la commande
+ * qu'il a lancée.
+ */
+static int invokeAndWait(MainWindow* window, const char* slot)
+{
+    GitJob* job = nullptr;
+    QMetaObject::invokeMethod(window, slot, Qt::DirectConnection, Q_RETURN_ARG(GitJob*, job));
+    if(!job)
+        return 0;
+    waitFor(job, &GitJob::finished);
+    return 1;
+}
+
+/**
+ * @param spec Dimensions du dépôt synthétique
+ * @param iterations Nombre d'itérations par mesure
+ * @return @c false si le dépôt n'a pas pu être généré
+ *
+ * Génère un dépôt puis mesure les chemins de rafraîchissement de l'interface
+ * sur ce dépôt : ouverture de la fenêtre principale, MainWindow::update_status,
+ * MainWindow::update_refs, MainWindow::update_all, la lecture des références
+ * et la mise à jour des fenêtres de branches et de tags.
+ */
+bool benchGui(const RepoSpec& spec, int iterations)
+{
+    QTemporaryDir dir;
+    RepoGenerator generator;
+    QElapsedTimer clock;
+    clock.start();
+    if(!dir.isValid() || !generator.generate(dir.path(), spec))
+    {
+        QTextStream(stderr) << "Génération du dépôt impossible : " << generator.errorString() << endl;
+        return false;
+    }
+    BenchResult generation;
+    generation.name = "repo/generate";
+    generation.iterations = 1;
+    generation.totalNs = clock.nsecsElapsed();
+    report(generation);
+
+    // Fenêtre principale sans rafraîchissement automatique, ni espace de
+    // travail dont les status s'ajouteraient aux mesures
+    qCtx->setCurrentGitDir(dir.path());
+    qCtx->setTimer(false);
+    qCtx->setWatch(false);
+    qCtx->setDeferredStartup(false); // Fenêtre jamais affichée
+    qCtx->setWorkspace(QStringList());
+    qCtx->setProcessPool(BENCH_PROCESS_POOL);
+
+    clock.start();
+    MainWindow* window = new MainWindow();
+    bool bReady = waitFor(window, &MainWindow::refreshed);
+    BenchResult open;
+    open.name = "gui/open";
+    open.iterations = 1;
+    open.totalNs = clock.nsecsElapsed();
+    report(open);
+    if(!bReady)
+    {
+        delete window;
+        return false;
+    }
+
+    report(measure("gui/update_status", iterations, [&]() {
+        return invokeAndWait(window, "update_status");
+    }));
+    report(measure("gui/update_refs", iterations, [&]() {
+        return invokeAndWait(window, "update_refs");
+    }));
+    report(measure("gui/update_all", iterations, [&]() {
+        QMetaObject::invokeMethod(window, "update_all", Qt::QueuedConnection);
+        return waitFor(window, &MainWindow::refreshed) ? 1 : 0;
+    }));
+    delete window;
+
+    // Références et fenêtres de gestion
+    const QString gitDir = dir.path() + "/.git";
+    RefReader reader;
+    reader.setRepository(gitDir, gitDir);
+    RefSnapshot refs;
+    report(measure("refs/read-cold", iterations, [&]() {
+        reader.clear();
+        reader.read(refs);
+        return refs.records().length();
+    }));
+    report(measure("refs/read-cached", iterations, [&]() {
+        reader.read(refs);
+        return refs.records().length();
+    }));
+
+    BranchWindow branchWindow;
+    report(measure("gui/BranchWindow::update_branches", iterations, [&]() {
+        branchWindow.update_branches(refs);
+        return refs.branches().length();
+    }));
+    TagsWindow tagsWindow;
+    report(measure("gui/TagsWindow::update_tags", iterations, [&]() {
+        tagsWindow.update_tags(refs);
+        return refs.tags().length();
+    }));
+    return true;
+}
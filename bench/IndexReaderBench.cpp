@@ -0,0 +1,168 @@
+#include "Bench.hpp"
+#include "IndexReader.hpp"
+#include "StagedIndex.hpp"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include <algorithm>
+
+/**
+ * @param out Données
+ * @param value Entier 16 bits ajouté en gros-boutiste
+ */
+static void appendBe16(QByteArray& out, quint16 value)
+{
+    out += char(value >> 8);
+    out += char(value & 0xFF);
+}
+
+/**
+ * @param out Données
+ * @param value Entier 32 bits ajouté en gros-boutiste
+ */
+static void appendBe32(QByteArray& out, quint32 value)
+{
+    appendBe16(out, quint16(value >> 16));
+    appendBe16(out, quint16(value & 0xFFFF));
+}
+
+/**
+ * @param out Données
+ * @param value Entier ajouté au format à longueur variable de l'index version 4
+ */
+static void appendVarint(QByteArray& out, quint32 value)
+{
+    uchar buffer[8];
+    int pos = sizeof(buffer) - 1;
+    buffer[pos] = uchar(value & 0x7F);
+    while(value >>= 7)
+    {
+        buffer[--pos] = uchar(0x80 | (--value & 0x7F));
+    }
+    out.append(reinterpret_cast<const char*>(buffer + pos), int(sizeof(buffer)) - pos);
+}
+
+/**
+ * @param paths Chemins triés
+ * @param version Version du format (2 ou 4)
+ * @param modified Une entrée sur @c modified reçoit un autre objet (0 pour aucune)
+ * @return Contenu d'un fichier @c index synthétique
+ */
+static QByteArray makeIndex(const QVector<QByteArray>& paths, int version, int modified)
+{
+    QByteArray out = "DIRC";
+    appendBe32(out, quint32(version));
+    appendBe32(out, quint32(paths.length()));
+
+    QByteArray previous;
+    for(int i = 0; i < paths.length(); i++)
+    {
+        const QByteArray& path = paths.at(i);
+        int start = out.length();
+        out.append(24, '\0');                   // ctime, mtime, dev, ino
+        appendBe32(out, 0100644);               // mode
+        out.append(8, '\0');                    // uid, gid
+        appendBe32(out, quint32(path.length()));// size
+        QByteArray oid = QByteArray::number(modified > 0 && i % modified == 0 ? -i - 1 : i);
+        oid = QCryptographicHash::hash(oid, QCryptographicHash::Sha1);
+        out += oid;
+        appendBe16(out, quint16(qMin(path.length(), 0xFFF)));
+        if(version == 4)
+        {
+            int common = 0;
+            while(common < previous.length() && common < path.length() && previous.at(common) == path.at(common))
+                common++;
+            appendVarint(out, quint32(previous.length() - common));
+            out += path.mid(common);
+            out += '\0';
+            previous = path;
+        }
+        else
+        {
+            out += path;
+            int length = ((out.length() - start) + 8) & ~7;
+            out.append(start + length - out.length(), '\0');
+        }
+    }
+
+    // Extension TREE invalidée
+    QByteArray tree("\0-1 0\n", 6);
+    out += "TREE";
+    appendBe32(out, quint32(tree.length()));
+    out += tree;
+    out += QCryptographicHash::hash(out, QCryptographicHash::Sha1);
+    return out;
+}
+
+/**
+ * @param path Fichier à écrire
+ * @param content Contenu
+ */
+static void writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    if(file.open(QIODevice::WriteOnly))
+    {
+        file.write(content);
+        file.close();
+    }
+}
+
+/**
+ * @param entries Nombre d'entrées de l'index
+ *
+ * Mesure la lecture d'un index synthétique en version 2 et 4, et le calcul des
+ * fichiers indexés par StagedIndex lorsqu'une entrée sur cent a changé.
+ */
+void benchIndexReader(int entries)
+{
+    const int iterations = 20;
+    QTemporaryDir dir;
+    if(!dir.isValid())
+        return;
+
+    QVector<QByteArray> paths;
+    paths.reserve(entries);
+    for(int i = 0; i < entries; i++)
+    {
+        paths << "src/module" + QByteArray::number(i % 97) + "/sub" + QByteArray::number(i % 7) +
+                 "/file" + QByteArray::number(i) + ".cpp";
+    }
+    std::sort(paths.begin(), paths.end());
+
+    const QString v2 = dir.filePath("index-v2");
+    const QString v4 = dir.filePath("index-v4");
+    const QString changed = dir.filePath("index-changed");
+    writeFile(v2, makeIndex(paths, 2, 0));
+    writeFile(v4, makeIndex(paths, 4, 0));
+    writeFile(changed, makeIndex(paths, 2, 100));
+
+    report(measure("index/open-v2/" + QString::number(entries), iterations, [&]() {
+        IndexReader index;
+        index.open(v2);
+        return index.entries().length();
+    }));
+    report(measure("index/open-v4/" + QString::number(entries), iterations, [&]() {
+        IndexReader index;
+        index.open(v4);
+        return index.entries().length();
+    }));
+
+    // Référence : status vide, HEAD identique à l'index
+    StagedIndex staged;
+    IndexReader base;
+    base.open(v2);
+    staged.rebuild(base, StatusParser(), QByteArray(40, '0'));
+    base.close();
+
+    report(measure("index/staged-diff/" + QString::number(entries), iterations, [&]() {
+        IndexReader index;
+        index.open(changed);
+        QVector<StagedChange> changes;
+        staged.diff(index, changes);
+        return changes.length();
+    }));
+}
@@ -0,0 +1,41 @@
+#include "Bench.hpp"
+#include "Logger.hpp"
+
+/**
+ * @param iterations Nombre de messages écrits par mesure
+ *
+ * Mesure l'écriture de messages dans le log courant, pour une ligne simple et
+ * pour un message de plusieurs lignes avec paramètres, puis le coût d'un
+ * message filtré par le niveau courant ou par un mot clé.
+ */
+void benchLogger(int iterations)
+{
+    report(measure("logger/info", iterations, [&]() {
+        qLog->info("Mise à jour du status");
+        return 1;
+    }));
+    report(measure("logger/info-args", iterations, [&]() {
+        qLog->info("Mise à jour globale terminée en", 42, "ms");
+        return 1;
+    }));
+    report(measure("logger/multiline", iterations, [&]() {
+        qLog->warning("GIT | git status\nfatal: not a git repository\nstderr");
+        return 1;
+    }));
+
+    qLog->setMinLevel(Logger::Warning);
+    report(measure("logger/suppressed-level", iterations, [&]() {
+        qLog->info("Mise à jour globale terminée en", 42, "ms");
+        return 1;
+    }));
+    qLog->setMinLevel(Logger::Debug);
+
+    qLog->setKeywordLevel("BENCH", Logger::Warning);
+    qLog->addKeyWord("BENCH");
+    report(measure("logger/suppressed-keyword", iterations, [&]() {
+        qLog->info("Mise à jour globale terminée en", 42, "ms");
+        return 1;
+    }));
+    qLog->removeKeyWord();
+    qLog->clearKeywordLevels();
+}
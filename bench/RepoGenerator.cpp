@@ -0,0 +1,154 @@
+#include "RepoGenerator.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+
+#define GIT_TIMEOUT_MS  600000  /**< Durée maximale d'une commande de génération */
+
+/**
+ * @return Dimensions au format JSON
+ */
+QJsonObject RepoSpec::toJson() const
+{
+    QJsonObject json;
+    json["files"] = files;
+    json["dirs"] = dirs;
+    json["modified"] = modified;
+    json["staged"] = staged;
+    json["untracked"] = untracked;
+    json["branches"] = branches;
+    json["tags"] = tags;
+    return json;
+}
+
+/**
+ * @param index Numéro du fichier
+ * @param dirs Nombre de dossiers
+ * @return Chemin relatif du fichier
+ */
+static QString filePath(int index, int dirs)
+{
+    return "dir" + QString::number(index % qMax(dirs, 1)) + "/file" + QString::number(index) + ".txt";
+}
+
+/**
+ * @param dir Dossier du dépôt (créé s'il n'existe pas)
+ * @param spec Dimensions du dépôt
+ * @return @c true si le dépôt a été créé
+ */
+bool RepoGenerator::generate(const QString& dir, const RepoSpec& spec)
+{
+    m_dir = dir;
+    m_error.clear();
+    if(!QDir().mkpath(dir))
+    {
+        m_error = "Impossible de créer " + dir;
+        return false;
+    }
+
+    if(!git(QStringList() << "init" << "-q") ||
+       !git(QStringList() << "config" << "user.name" << "GitIHM Bench") ||
+       !git(QStringList() << "config" << "user.email" << "bench@gitihm") ||
+       !git(QStringList() << "config" << "commit.gpgsign" << "false"))
+        return false;
+
+    // Commit initial
+    for(int i = 0; i < spec.dirs; i++)
+    {
+        QDir(dir).mkpath("dir" + QString::number(i));
+    }
+    for(int i = 0; i < spec.files; i++)
+    {
+        if(!writeFile(filePath(i, spec.dirs), "line " + QByteArray::number(i) + '\n'))
+            return false;
+    }
+    if(!git(QStringList() << "add" << "-A") ||
+       !git(QStringList() << "commit" << "-q" << "-m" << "Initial commit"))
+        return false;
+
+    // Branches et tags
+    QByteArray refs;
+    for(int i = 0; i < spec.branches; i++)
+    {
+        refs += "create refs/heads/branch" + QByteArray::number(i) + " HEAD\n";
+    }
+    for(int i = 0; i < spec.tags; i++)
+    {
+        refs += "create refs/tags/v" + QByteArray::number(i) + " HEAD\n";
+    }
+    if(!refs.isEmpty() && !git(QStringList() << "update-ref" << "--stdin", refs))
+        return false;
+
+    // Fichiers indexés puis modifiés, les deux ensembles sont disjoints
+    const int staged = int(spec.files * spec.staged);
+    const int modified = int(spec.files * spec.modified);
+    QByteArray stagedPaths;
+    for(int i = 0; i < staged && i < spec.files; i++)
+    {
+        QString path = filePath(i, spec.dirs);
+        if(!writeFile(path, "staged " + QByteArray::number(i) + '\n'))
+            return false;
+        stagedPaths += path.toUtf8() + '\n';
+    }
+    if(!stagedPaths.isEmpty() && !git(QStringList() << "update-index" << "--stdin", stagedPaths))
+        return false;
+    for(int i = staged; i < staged + modified && i < spec.files; i++)
+    {
+        if(!writeFile(filePath(i, spec.dirs), "modified " + QByteArray::number(i) + '\n'))
+            return false;
+    }
+
+    // Fichiers non suivis
+    const int untracked = int(spec.files * spec.untracked);
+    for(int i = 0; i < untracked; i++)
+    {
+        if(!writeFile("dir" + QString::number(i % qMax(spec.dirs, 1)) + "/new" + QString::number(i) + ".txt", "new\n"))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @param args Arguments de la commande Git
+ * @param input Données écrites sur l'entrée standard
+ * @return @c true si la commande a réussi
+ */
+bool RepoGenerator::git(const QStringList& args, const QByteArray& input /*= QByteArray()*/)
+{
+    QProcess process;
+    process.setWorkingDirectory(m_dir);
+    process.start("git", args);
+    if(!process.waitForStarted())
+    {
+        m_error = "git introuvable";
+        return false;
+    }
+    if(!input.isEmpty())
+        process.write(input);
+    process.closeWriteChannel();
+    if(!process.waitForFinished(GIT_TIMEOUT_MS) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+    {
+        m_error = "git " + args.join(' ') + " : " + QString::fromLocal8Bit(process.readAllStandardError());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @param path Chemin relatif au dépôt
+ * @param content Contenu du fichier
+ * @return @c true si le fichier a été écrit
+ */
+bool RepoGenerator::writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(m_dir + '/' + path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        m_error = file.fileName() + " : " + file.errorString();
+        return false;
+    }
+    file.write(content);
+    file.close();
+    return true;
+}
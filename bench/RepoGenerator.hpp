@@ -0,0 +1,49 @@
+#ifndef REPOGENERATOR_HPP
+#define REPOGENERATOR_HPP
+
+    #include <QString>
+    #include <QStringList>
+    #include <QJsonObject>
+
+    /**
+     * @struct RepoSpec
+     * @brief Dimensions d'un dépôt synthétique.
+     */
+    struct RepoSpec
+    {
+        int files = 10000;/**< Nombre de fichiers suivis */
+        int dirs = 100;/**< Nombre de dossiers */
+        double modified = 0.01;/**< Part des fichiers modifiés dans la copie de travail */
+        double staged = 0.01;/**< Part des fichiers modifiés et indexés */
+        double untracked = 0.01;/**< Nombre de fichiers non suivis, rapporté au nombre de fichiers suivis */
+        int branches = 50;/**< Nombre de branches locales (en plus de la branche courante) */
+        int tags = 200;/**< Nombre de tags */
+
+        QJsonObject toJson() const;
+    };
+
+    /**
+     * @class RepoGenerator
+     * @brief La classe RepoGenerator crée un dépôt Git synthétique.
+     *
+     * Le dépôt est créé avec la commande @b git : un commit initial contenant
+     * tous les fichiers, les branches et tags créés en une seule commande
+     * @b git @b update-ref @b --stdin, puis les modifications de la copie de
+     * travail et de l'index.
+     */
+    class RepoGenerator
+    {
+        public:
+            bool generate(const QString& dir, const RepoSpec& spec);
+            QString errorString() const             { return m_error;   }
+
+        private:
+            bool git(const QStringList& args, const QByteArray& input = QByteArray());
+            bool writeFile(const QString& path, const QByteArray& content);
+
+        private:
+            QString m_dir;/**< Dossier du dépôt */
+            QString m_error;/**< Dernière erreur */
+    };
+
+#endif // REPOGENERATOR_HPP
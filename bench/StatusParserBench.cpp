@@ -0,0 +1,119 @@
+#include "Bench.hpp"
+#include "StatusParser.hpp"
+
+#include <QStringList>
+
+#define ZERO_OID QByteArray(40, '0')
+
+/**
+ * @param entries Nombre d'entrées
+ * @return Sortie synthétique de @b git @b status @b -s
+ */
+static QByteArray makeShortStatus(int entries)
+{
+    QByteArray out;
+    for(int i = 0; i < entries; i++)
+    {
+        QByteArray path = "src/module" + QByteArray::number(i % 97) + "/file" + QByteArray::number(i) + ".cpp";
+        switch(i % 4)
+        {
+            case 0: out += "M  " + path + '\n'; break;
+            case 1: out += " M " + path + '\n'; break;
+            case 2: out += "MM " + path + '\n'; break;
+            default: out += "?? " + path + '\n'; break;
+        }
+    }
+    return out;
+}
+
+/**
+ * @param entries Nombre d'entrées
+ * @return Sortie synthétique de @b git @b status @b --porcelain=v2 @b -z
+ */
+static QByteArray makePorcelainV2(int entries)
+{
+    QByteArray out;
+    for(int i = 0; i < entries; i++)
+    {
+        QByteArray path = "src/module" + QByteArray::number(i % 97) + "/file" + QByteArray::number(i) + ".cpp";
+        QByteArray xy;
+        switch(i % 4)
+        {
+            case 0: xy = "M."; break;
+            case 1: xy = ".M"; break;
+            case 2: xy = "MM"; break;
+            default: out += "? " + path + '\0'; continue;
+        }
+        out += "1 " + xy + " N... 100644 100644 100644 " + ZERO_OID + ' ' + ZERO_OID + ' ' + path + '\0';
+    }
+    return out;
+}
+
+/**
+ * @param raw Sortie de @b git @b status @b -s
+ * @return Nombre de fichiers
+ *
+ * Reproduit l'analyse historique de MainWindow::update_status : conversion
+ * en QString, découpage en lignes, tri et extraction du nom par @c right.
+ */
+static int legacyParse(const QByteArray& raw)
+{
+    QStringList state_list = QString(raw).split('\n');
+    state_list.sort();
+    int count = 0;
+    for(QString state : state_list)
+    {
+        if(state.length() > 3)
+        {
+            QString file_name = state.right(state.length()-3);
+            if(state.at(0) != QChar('U') && state.at(1) != QChar('U'))
+                count += file_name.length() > 0;
+        }
+    }
+    return count;
+}
+
+/**
+ * @param raw Sortie de @b git @b status @b --porcelain=v2 @b -z
+ * @return Nombre de fichiers
+ *
+ * Analyse avec StatusParser et décode chaque chemin, comme le fait
+ * MainWindow::update_status.
+ */
+static int parserParse(const QByteArray& raw)
+{
+    StatusParser parser;
+    parser.parse(raw);
+    int count = 0;
+    for(const StatusEntry& entry : parser.entries())
+    {
+        if(entry.kind != StatusEntry::Unmerged)
+            count += parser.path(entry).length() > 0;
+    }
+    return count;
+}
+
+/**
+ * @param entries Nombre d'entrées de status à analyser
+ *
+ * Compare l'analyse historique de @b git @b status @b -s à StatusParser, avec
+ * et sans décodage des chemins.
+ */
+void benchStatusParser(int entries)
+{
+    const int iterations = 20;
+    QByteArray shortStatus = makeShortStatus(entries);
+    QByteArray v2Status = makePorcelainV2(entries);
+
+    report(measure("status/legacy-split/" + QString::number(entries), iterations, [&]() {
+        return legacyParse(shortStatus);
+    }));
+    report(measure("status/parser-decode/" + QString::number(entries), iterations, [&]() {
+        return parserParse(v2Status);
+    }));
+    report(measure("status/parser-only/" + QString::number(entries), iterations, [&]() {
+        StatusParser parser;
+        parser.parse(v2Status);
+        return parser.entries().length();
+    }));
+}
@@ -0,0 +1,143 @@
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVariant>
+
+#include "Bench.hpp"
+#include "Logger.hpp"
+
+#define BENCH_FORMAT_VERSION 1 /**< Version du format JSON des résultats */
+
+volatile qint64 g_benchSink = 0;
+static QVector<BenchResult> g_results;
+
+/**
+ * @param result Résultat à afficher
+ *
+ * Affiche le résultat d'une mesure sur la sortie d'erreur et le conserve pour
+ * le rapport JSON.
+ */
+void report(const BenchResult& result)
+{
+    g_results.append(result);
+    QTextStream out(stderr);
+    out << result.name << " : " << result.iterations << " itérations, "
+        << result.perIteration() / 1000 << " us/itération" << endl;
+}
+
+/**
+ * @return Résultats de toutes les mesures
+ */
+const QVector<BenchResult>& results()
+{
+    return g_results;
+}
+
+/**
+ * Les messages de Qt (et la copie des logs par le Logger) ne sont pas affichés
+ * pendant les mesures.
+ */
+static void quietHandler(QtMsgType, const QMessageLogContext&, const QString&)
+{
+}
+
+/**
+ * @param args Arguments de la ligne de commande
+ * @param name Option recherchée
+ * @param value Valeur par défaut, remplacée par celle de l'option
+ */
+template<class T> static void option(const QStringList& args, const QString& name, T& value)
+{
+    int idx = args.indexOf(name);
+    if(idx != -1 && idx + 1 < args.length())
+    {
+        value = QVariant(args.at(idx + 1)).value<T>();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Exécution sans affichage
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication a(argc, argv);
+
+    QStringList args = a.arguments();
+    int entries = 20000;
+    int indexEntries = 100000;
+    int iterations = 20;
+    QString json;
+    RepoSpec spec;
+    option(args, "--entries", entries);
+    option(args, "--index-entries", indexEntries);
+    option(args, "--iterations", iterations);
+    option(args, "--json", json);
+    option(args, "--files", spec.files);
+    option(args, "--dirs", spec.dirs);
+    option(args, "--modified", spec.modified);
+    option(args, "--staged", spec.staged);
+    option(args, "--untracked", spec.untracked);
+    option(args, "--branches", spec.branches);
+    option(args, "--tags", spec.tags);
+
+    // Dossier de travail temporaire : le GitIHM.ini et le GitIHM.cache de
+    // l'utilisateur ne sont ni lus ni modifiés par les mesures
+    QTemporaryDir workDir;
+    if(!workDir.isValid())
+        return 2;
+    if(!json.isEmpty() && json != "-")
+        json = QFileInfo(json).absoluteFilePath();
+    QDir::setCurrent(workDir.path());
+
+    qInstallMessageHandler(quietHandler);
+    qLog->createLog(QDir::temp().filePath("GitIHMBench.log"), true);
+
+    benchStatusParser(entries);
+    benchIndexReader(indexEntries);
+    benchLogger(iterations * 1000);
+    bool bGui = args.contains("--no-gui") || benchGui(spec, iterations);
+    qLog->close();
+    qInstallMessageHandler(nullptr);
+
+    // Rapport JSON : sortie standard ou fichier
+    QJsonArray list;
+    for(const BenchResult& result : results())
+    {
+        QJsonObject item;
+        item["name"] = result.name;
+        item["iterations"] = result.iterations;
+        item["total_ns"] = double(result.totalNs);
+        item["per_iteration_ns"] = double(result.perIteration());
+        list.append(item);
+    }
+    QJsonObject root;
+    root["format"] = BENCH_FORMAT_VERSION;
+    root["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qt"] = QString(qVersion());
+    root["repository"] = spec.toJson();
+    root["results"] = list;
+    QByteArray document = QJsonDocument(root).toJson();
+
+    if(json.isEmpty() || json == "-")
+    {
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        out.write(document);
+    }
+    else
+    {
+        QFile out(json);
+        if(!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return 2;
+        out.write(document);
+    }
+    return bGui ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+QT       += core
+QT       -= gui
+
+TARGET = GitIHMStartupBench
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DESTDIR = ./../../../build
+
+SOURCES += \
+        main.cpp \
+        ../RepoGenerator.cpp
+
+HEADERS += \
+        ../RepoGenerator.hpp
+
+INCLUDEPATH += ..
@@ -0,0 +1,229 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVariant>
+
+#include "RepoGenerator.hpp"
+
+#define BENCH_FORMAT_VERSION    1       /**< Version du format JSON des résultats (identique à GitIHMBench) */
+#define RUN_TIMEOUT_MS          600000  /**< Durée maximale d'un lancement de l'application */
+
+/**
+ * @struct StartupRun
+ * @brief Dates mesurées lors d'un lancement de l'application (ns depuis le lancement du processus).
+ */
+struct StartupRun
+{
+    qint64 firstPaint = -1;/**< Premier affichage de la fenêtre */
+    qint64 firstStatus = -1;/**< Fin de la première mise à jour complète */
+};
+
+/**
+ * @param args Arguments de la ligne de commande
+ * @param name Option recherchée
+ * @param value Valeur par défaut, remplacée par celle de l'option
+ */
+template<class T> static void option(const QStringList& args, const QString& name, T& value)
+{
+    int idx = args.indexOf(name);
+    if(idx != -1 && idx + 1 < args.length())
+    {
+        value = QVariant(args.at(idx + 1)).value<T>();
+    }
+}
+
+/**
+ * @param workDir Dossier d'exécution de l'application (GitIHM.ini, cache)
+ * @param repo Dépôt à ouvrir
+ * @param deferred Démarrage différé (voir Context::deferredStartup)
+ * @return @c false si le fichier INI n'a pas pu être écrit
+ *
+ * Ecrit le fichier INI de l'application : rafraîchissements automatiques
+ * désactivés pour ne mesurer que le démarrage.
+ */
+static bool writeIni(const QString& workDir, const QString& repo, bool deferred)
+{
+    QFile file(workDir + "/GitIHM.ini");
+    if(!file.open(QIODevice::Text | QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    stream << "git-dir=" << repo << endl;
+    stream << "timer-enable=false" << endl;
+    stream << "watch-enable=false" << endl;
+    stream << "deferred-startup=" << (deferred ? "true" : "false");
+    return true;
+}
+
+/**
+ * @param app Exécutable GitIHM
+ * @param workDir Dossier d'exécution
+ * @param run Dates mesurées
+ * @return @c false si l'application n'a pas signalé sa première mise à jour
+ *
+ * Lance l'application avec l'option @c --startup-report et date la réception
+ * de chaque ligne de rapport, depuis le lancement du processus : le
+ * chargement des bibliothèques est compris dans la mesure.
+ */
+static bool launch(const QString& app, const QString& workDir, StartupRun& run)
+{
+    QProcess process;
+    process.setWorkingDirectory(workDir);
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    QElapsedTimer clock;
+    clock.start();
+    process.start(app, QStringList() << "--startup-report");
+    if(!process.waitForStarted())
+        return false;
+
+    QByteArray pending;
+    while(run.firstStatus < 0 && clock.elapsed() < RUN_TIMEOUT_MS)
+    {
+        if(!process.waitForReadyRead(RUN_TIMEOUT_MS - int(clock.elapsed())))
+            break;
+        qint64 now = clock.nsecsElapsed();
+        pending += process.readAllStandardOutput();
+        int end;
+        while((end = pending.indexOf('\n')) != -1)
+        {
+            QByteArray line = pending.left(end).trimmed();
+            pending.remove(0, end + 1);
+            if(line.startsWith("first-paint "))
+                run.firstPaint = now;
+            else if(line.startsWith("first-status "))
+                run.firstStatus = now;
+        }
+    }
+    if(!process.waitForFinished(RUN_TIMEOUT_MS))
+        process.kill();
+    return run.firstPaint >= 0 && run.firstStatus >= 0;
+}
+
+/**
+ * @param name Nom de la mesure
+ * @param total Durée cumulée (ns)
+ * @param iterations Nombre de lancements
+ * @return Résultat au format de GitIHMBench
+ */
+static QJsonObject result(const QString& name, qint64 total, int iterations)
+{
+    QJsonObject item;
+    item["name"] = name;
+    item["iterations"] = iterations;
+    item["total_ns"] = double(total);
+    item["per_iteration_ns"] = double(iterations > 0 ? total / iterations : 0);
+    QTextStream(stderr) << name << " : " << iterations << " lancements, "
+                        << (iterations > 0 ? total / iterations / 1000000 : 0) << " ms/lancement" << endl;
+    return item;
+}
+
+/**
+ * Mesure le démarrage de GitIHM sur un dépôt synthétique de grande taille :
+ * durée entre le lancement du processus et le premier affichage, puis la
+ * première mise à jour complète. Chaque mesure est faite en démarrage direct
+ * et différé, sans cache (premier lancement) et avec le cache du lancement
+ * précédent.@n
+ * Options : @c --app (exécutable GitIHM, par défaut à côté de ce programme),
+ * @c --iterations, @c --json, et les dimensions du dépôt comme GitIHMBench.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QStringList args = a.arguments();
+    QString app = QDir(a.applicationDirPath()).filePath("GitIHM");
+    int iterations = 5;
+    QString json;
+    RepoSpec spec;
+    spec.files = 100000;
+    spec.dirs = 1000;
+    option(args, "--app", app);
+    option(args, "--iterations", iterations);
+    option(args, "--json", json);
+    option(args, "--files", spec.files);
+    option(args, "--dirs", spec.dirs);
+    option(args, "--modified", spec.modified);
+    option(args, "--staged", spec.staged);
+    option(args, "--untracked", spec.untracked);
+    option(args, "--branches", spec.branches);
+    option(args, "--tags", spec.tags);
+
+    QTemporaryDir repoDir;
+    QTemporaryDir workDir;
+    RepoGenerator generator;
+    if(!repoDir.isValid() || !workDir.isValid() || !generator.generate(repoDir.path(), spec))
+    {
+        QTextStream(stderr) << "Génération du dépôt impossible : " << generator.errorString() << endl;
+        return 2;
+    }
+
+    // Exécution sans affichage
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QJsonArray list;
+    bool bOk = true;
+    for(bool deferred : { false, true })
+    {
+        for(bool cached : { false, true })
+        {
+            if(!writeIni(workDir.path(), repoDir.path(), deferred))
+                return 2;
+            QString name = QString("startup/") + (deferred ? "deferred" : "direct") + (cached ? "-cached" : "-cold");
+            qint64 paint = 0;
+            qint64 status = 0;
+            int runs = 0;
+            for(int i = 0; i < iterations; i++)
+            {
+                // Le lancement précédent a écrit le cache : il est supprimé pour un démarrage à froid
+                if(!cached)
+                    QDir(workDir.path() + "/GitIHM.cache").removeRecursively();
+                StartupRun run;
+                if(!launch(app, workDir.path(), run))
+                {
+                    QTextStream(stderr) << name << " : échec du lancement de " << app << endl;
+                    bOk = false;
+                    break;
+                }
+                paint += run.firstPaint;
+                status += run.firstStatus;
+                runs++;
+            }
+            list.append(result(name + "/first-paint", paint, runs));
+            list.append(result(name + "/first-status", status, runs));
+        }
+    }
+
+    // Rapport JSON : sortie standard ou fichier
+    QJsonObject root;
+    root["format"] = BENCH_FORMAT_VERSION;
+    root["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qt"] = QString(qVersion());
+    root["repository"] = spec.toJson();
+    root["results"] = list;
+    QByteArray document = QJsonDocument(root).toJson();
+
+    if(json.isEmpty() || json == "-")
+    {
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        out.write(document);
+    }
+    else
+    {
+        QFile out(json);
+        if(!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return 2;
+        out.write(document);
+    }
+    return bOk ? 0 : 1;
+}
@@ -4,6 +4,8 @@
     #include <QMainWindow>
     #include <QListWidgetItem>
 
+    #include "RefSnapshot.hpp"
+
     namespace Ui {
         class BranchWindow;
     }
@@ -25,7 +27,7 @@
             ~BranchWindow();
 
         public slots:
-            void update_branches(QStringList branches);
+            void update_branches(const RefSnapshot& refs);
 
         signals:
             /**
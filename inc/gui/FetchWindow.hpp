@@ -0,0 +1,48 @@
+#ifndef FETCHWINDOW_HPP
+#define FETCHWINDOW_HPP
+
+    #include <QMainWindow>
+    #include "GitExecutor.hpp"
+
+    namespace Ui {
+    class FetchWindow;
+    }
+
+    /**
+     * @class FetchWindow
+     * @brief La classe FetchWindow affiche l'avancement d'un fetch de plusieurs
+     * dépôts distants.
+     *
+     * Chaque dépôt distant a sa ligne : progression de la commande puis résultat
+     * (succès ou première ligne de l'erreur). Le bouton Annuler annule toutes les
+     * commandes qui ne sont pas terminées.@n
+     * Header : FetchWindow.hpp
+     */
+    class FetchWindow : public QMainWindow
+    {
+        Q_OBJECT
+
+        public:
+            FetchWindow(QWidget *parent = nullptr, const QStringList& remotes = QStringList());
+            ~FetchWindow();
+            void track(int row, GitJob* job);
+
+        signals:
+            /**
+             * Ce signal est émit par le bouton Annuler.
+             */
+            void cancel();
+
+        private slots:
+            void on_pushButton_cancel_clicked();
+
+        private:
+            void updateSummary();
+
+        private:
+            Ui::FetchWindow *ui;/**< UI de la classe FetchWindow */
+            int m_pending;/**< Nombre de commandes en cours */
+            int m_failed;/**< Nombre de commandes en échec */
+    };
+
+#endif // FETCHWINDOW_HPP
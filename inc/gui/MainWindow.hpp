@@ -1,14 +1,32 @@
 #ifndef MAINWINDOW_HPP
 #define MAINWINDOW_HPP
 
-    #include <QProcess>
-    #include <QListWidget>
+    #include <QListView>
     #include <QTimer>
+    #include <QElapsedTimer>
     #include <QMainWindow>
+    #include <QPointer>
+    #include <QProgressBar>
+    #include <QToolButton>
+    #include <functional>
+    #include "GitExecutor.hpp"
+    #include "StatusModel.hpp"
+    #include "RepoWatcher.hpp"
+    #include "RepoFingerprint.hpp"
+    #include "StagedIndex.hpp"
+    #include "RefService.hpp"
+    #include "Workspace.hpp"
+    #include "RefreshCoalescer.hpp"
+    #include "StatusCache.hpp"
+    #include "RepoLocator.hpp"
 
     #define GIT_COMMIT_DEFAULT_MSG QString("Commit without message")/**< Message par défaut pour un commit si aucun message n'est renseigné */
     #define GIT_COMMIT_PLACEHOLDER QString("Ajoutez un message au commit")/**< Affichage dans la ligne d'édition du commit si aucun message renseigné */
 
+    #define TIMER_COST_FACTOR       4       /**< Rapport minimal entre l'intervalle du timer et la durée lissée d'un status */
+    #define TIMER_INACTIVE_FACTOR   4       /**< Allongement de l'intervalle du timer lorsque la fenêtre n'est pas active */
+    #define TIMER_MAX_INTERVAL      600     /**< Intervalle maximal du timer après adaptation (s) */
+
     #define GIT_STATUS_LABEL_0 QString("Non modifié")
     #define GIT_STATUS_LABEL_1 QString("Non suivi")
     #define GIT_STATUS_LABEL_2 QString("Ignoré")
@@ -39,32 +57,43 @@
             void init();
             void clear();
 
+        protected:
+            void changeEvent(QEvent* event) override;
+            void showEvent(QShowEvent* event) override;
+            void hideEvent(QHideEvent* event) override;
+            bool eventFilter(QObject* watched, QEvent* event) override;
+
         signals:
             /**
              * Ce signal est émit en cas de création d'un nouveau tag.
              */
             void tag_created();
             /**
-             * @param tags Liste des tags
+             * @param refs Liste des références
              *
-             * Ce signal est émit pour mettre à jour la liste des tag dans la fenêtre
-             * de gestion des tags.
+             * Ce signal est émit pour mettre à jour la liste des branches et des tags
+             * dans les fenêtres de gestion des branches et des tags.
              */
-            void tag_update(QStringList tags);
+            void refs_update(const RefSnapshot& refs);
             /**
-             * @param branches Liste des tags
-             *
-             * Ce signal est émit pour mettre à jour la liste des branches dans la fenêtre
-             * de gestion des branches.
+             * Ce signal est émit à la fin d'une mise à jour globale (voir
+             * MainWindow::update_all), lorsque toutes ses requêtes sont terminées.
+             */
+            void refreshed();
+            /**
+             * Ce signal est émit une seule fois, après le premier affichage de
+             * la fenêtre.
              */
-            void branch_update(QStringList branches);
+            void firstPaint();
 
         private slots:
             // Update
             void update_all();
-            void update_status();
-            void update_branches();
-            void update_remote();
+            void refresh_flush(int resources);
+            GitJob* update_status();
+            GitJob* update_refs();
+            GitJob* update_untracked();
+            void refs_updated(const RefSnapshot& refs);
             // Commit
             void on_pushButton_commit_clicked();
             void on_checkBox_amend_stateChanged(int arg1);
@@ -82,6 +111,7 @@
             void on_pushButton_tags_clicked();
             void on_pushButton_push_clicked();
             void on_pushButton_fetch_clicked();
+            void on_pushButton_fetchAll_clicked();
             void on_pushButton_rebase_clicked();
             void on_pushButton_extra_clicked();
             void on_lineEdit_extra_returnPressed();
@@ -91,32 +121,77 @@
             void on_toolButton_refresh_clicked();
             void on_checkBox_autoRefresh_stateChanged(int arg1);
             void on_spinBox_timerTime_valueChanged(int arg1);
+            void on_checkBox_watch_stateChanged(int arg1);
+            void repository_changed(int changes);
+            void timer_tick();
             void on_pushButton_stash_clicked();
             void on_pushButton_pop_clicked();
             void on_pushButton_conflict_clicked();
             void closeMergeTool();
+            void export_trace();
+            void cancel_command();
+            void first_paint();
 
         private:
-            bool action(QStringList args, bool status = true);
-            QStringList getSelected(QListWidget* list_view, bool only_files = true);
-            QStringList getAllItems(QListWidget* list_view, bool only_files = true);
+            typedef std::function<void(const GitResult&)> GitCallback;/**< Traitement à exécuter en cas de succès d'une commande */
+            GitJob* action(QStringList args, GitCallback onSuccess = nullptr, bool b_status = true,
+                           GitExecutor::Mode mode = GitExecutor::Write, bool b_stream = false);
+            GitJob* query(QStringList args, GitCallback onSuccess);
+            QStringList getSelected(QListView* list_view);
             QString stateChar2Label(QChar c, bool staged = false);
-            bool setGitDir(const QString& dirName);
+            void setGitDir(const QString& dirName, bool b_check = true);
+            // Cache
+            void loadCache(const QString& path);
+            void saveCache();
             // Update
-            bool checkForGitDir();
-            void updateStash();
+            void checkForGitDir();
+            int tickInterval() const;
+            void scheduleTick();
+            GitJob* updateStash();
+            QByteArray updateStagedFromIndex(const QByteArray& head);
+            void updateCommitButton();
+            void updateUnstaged();
+            // Progression
+            void showProgress(GitJob* job);
+            void hideProgress();
             // Status
             void status(const QString& msg);
 
         private:
             Ui::MainWindow *ui;/**< UI de la classe MainWindow */
-            QProcess* m_process;/**< Processus pour exécution des commandes Git */
-            int m_last_exit_code;/**< Dernier code retour du processus */
-            QString m_output;/**< Sortie standard du dernier processus */
-            QString m_error;/**< Erreur standard du dernier processus */
+            StatusModel* m_stagedModel;/**< Modèle de la liste des fichiers indexés */
+            StatusModel* m_unstagedModel;/**< Modèle de la liste des fichiers non indexés */
             QStringList m_unmerged;/**< Liste des fichiers en conflit */
             bool m_bInGitDir;
-            QTimer m_timer;
+            bool m_bFirstPaint;/**< La fenêtre a été affichée au moins une fois */
+            bool m_bStatusPending;/**< Une commande de status est en cours */
+            bool m_bStatusAgain;/**< Un nouveau status a été demandé pendant l'exécution du précédent */
+            bool m_bUntrackedPending;/**< Une recherche des fichiers non suivis est en cours */
+            bool m_bUntrackedAgain;/**< Une nouvelle recherche a été demandée pendant l'exécution de la précédente */
+            QVector<StatusItem> m_unstagedTracked;/**< Fichiers suivis non indexés (dernier status -uno) */
+            QVector<StatusItem> m_untracked;/**< Fichiers non suivis (dernière recherche) */
+            int m_refreshPending;/**< Nombre de requêtes de la mise à jour globale en cours */
+            QElapsedTimer m_refreshClock;/**< Chronomètre de la mise à jour globale */
+            qint64 m_refreshTraceStart;/**< Début de la mise à jour globale (voir Tracer::now) */
+            bool m_bRefreshAll;/**< Une mise à jour globale attend le prochain regroupement (voir MainWindow::refresh_flush) */
+            int m_fetchPending;/**< Nombre de fetch en cours (voir MainWindow::on_pushButton_fetchAll_clicked) */
+            QTimer m_timer;/**< Timer de rafraîchissement automatique, réarmé à la fin de chaque status */
+            QTimer m_untrackedTimer;/**< Timer de la recherche périodique des fichiers non suivis */
+            qint64 m_statusCost;/**< Durée lissée d'un status (ms, 0 : pas encore mesurée) */
+            QProgressBar* m_progress;/**< Progression de la commande en cours */
+            QToolButton* m_cancel;/**< Annulation de la commande en cours */
+            QPointer<GitJob> m_statusJob;/**< Commande affichée dans la barre de status */
+            RepoWatcher* m_watcher;/**< Surveillance des fichiers du dépôt */
+            RefreshCoalescer* m_refresh;/**< Regroupement des demandes de rafraîchissement */
+            RefService* m_refs;/**< Références du dépôt (branches, tags, distants) */
+            Workspace* m_workspace;/**< Dépôts de l'espace de travail */
+            RepoFingerprint m_fingerprint;/**< Empreinte du dépôt au dernier tick du timer */
+            RepoLocator m_locator;/**< Recherche du dépôt du dossier courant, sans processus */
+            StatusCache m_cache;/**< Dernier état affiché, enregistré sur disque */
+            StagedIndex m_stagedIndex;/**< Calcul des fichiers indexés par lecture directe de l'index */
+            QElapsedTimer m_lastAutoRefresh;/**< Chronomètre depuis le dernier status lancé par le timer */
+            int m_ticksRun;/**< Nombre de ticks du timer ayant lancé un status */
+            int m_ticksSkipped;/**< Nombre de ticks du timer ignorés (empreinte inchangée) */
     };
 
 #endif // MAINWINDOW_HPP
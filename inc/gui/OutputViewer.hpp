@@ -0,0 +1,54 @@
+#ifndef OUTPUTVIEWER_HPP
+#define OUTPUTVIEWER_HPP
+
+    #include <QMainWindow>
+    #include <QTextDecoder>
+    #include "GitExecutor.hpp"
+
+    #define OUTPUT_MAX_LINES    20000   /**< Nombre maximal de lignes affichées (les plus anciennes sont supprimées) */
+    #define OUTPUT_MAX_PARTIAL  65536   /**< Taille maximale d'une ligne incomplète avant son affichage */
+    #define OUTPUT_MAX_CHARS    (4 * 1024 * 1024)   /**< Nombre maximal de caractères affichés (les lignes les plus anciennes sont supprimées) */
+
+    namespace Ui {
+        class OutputViewer;
+    }
+
+    /**
+     * @class OutputViewer
+     * @brief La classe OutputViewer affiche la sortie d'une commande au fil de
+     * son exécution.
+     *
+     * La sortie est décodée en UTF-8 par parties (un caractère peut être coupé
+     * entre deux parties) et affichée par lignes complètes. Seules les
+     * #OUTPUT_MAX_LINES dernières lignes sont conservées, dans la limite de
+     * #OUTPUT_MAX_CHARS caractères, quelle que soit la taille de la sortie.@n
+     * La fenêtre ne s'affiche qu'à la réception de la première partie de la
+     * sortie et se détruit à sa fermeture, ou à la fin d'une commande sans
+     * sortie.@n
+     * Header : OutputViewer.hpp
+     */
+    class OutputViewer : public QMainWindow
+    {
+        Q_OBJECT
+
+        public:
+            OutputViewer(QWidget *parent = nullptr, const QString& title = "Sortie");
+            ~OutputViewer();
+
+        public slots:
+            void append(const QByteArray& chunk);
+            void finish(const GitResult& result);
+
+        private:
+            void trim();
+            void updateState(const QString& state);
+
+        private:
+            Ui::OutputViewer *ui;/**< UI de la classe OutputViewer */
+            QTextDecoder* m_decoder;/**< Décodage UTF-8 des parties de la sortie */
+            QString m_partial;/**< Dernière ligne incomplète */
+            qint64 m_bytes;/**< Nombre d'octets reçus */
+            int m_lines;/**< Nombre de lignes reçues */
+    };
+
+#endif // OUTPUTVIEWER_HPP
@@ -0,0 +1,109 @@
+#ifndef PERFDOCK_HPP
+#define PERFDOCK_HPP
+
+    #include <QDockWidget>
+    #include <QElapsedTimer>
+    #include <QHash>
+    #include <QQueue>
+    #include <QTimer>
+    #include <QVector>
+    #include "GitExecutor.hpp"
+
+    #define PERF_RECENT     200     /**< Nombre de commandes affichées */
+    #define PERF_SAMPLES    500     /**< Nombre de durées conservées par type de commande */
+    #define PERF_WINDOW_MS  60000   /**< Fenêtre de calcul du coût du rafraîchissement (ms) */
+    #define PERF_REFRESH_MS 1000    /**< Période de mise à jour des statistiques (ms) */
+
+    namespace Ui {
+        class PerfDock;
+    }
+
+    /**
+     * @class PerfDock
+     * @brief La classe PerfDock affiche le coût des commandes Git.
+     *
+     * Ce panneau ancrable liste les dernières commandes exécutées par
+     * GitExecutor (arguments, durée, attente, taille des sorties, code retour),
+     * les percentiles p50/p95/p99 de la durée de chaque type de commande et le
+     * coût du rafraîchissement sur la dernière minute : part du temps occupée par
+     * des processus Git et temps CPU consommé par l'application et ses
+     * processus.@n
+     * Si le p95 du @b git @b status dépasse la moitié de l'intervalle du
+     * rafraîchissement automatique, le coût est affiché en alerte.@n
+     * Header : PerfDock.hpp
+     */
+    class PerfDock : public QDockWidget
+    {
+        Q_OBJECT
+
+        public:
+            PerfDock(QWidget *parent = nullptr);
+            ~PerfDock();
+
+        private slots:
+            void job_finished(const GitResult& result);
+            void refresh();
+
+        protected:
+            void showEvent(QShowEvent* event) override;
+
+        private:
+            /**
+             * @struct Invocation
+             * @brief Résumé d'une commande terminée.
+             */
+            struct Invocation
+            {
+                QString command;/**< Arguments de la commande */
+                qint64 elapsed;/**< Durée d'exécution (ms) */
+                qint64 waited;/**< Attente dans la file (ms) */
+                qint64 outputSize;/**< Taille de la sortie standard (octets) */
+                int errorSize;/**< Taille de l'erreur standard (octets) */
+                int exitCode;/**< Code retour */
+            };
+
+            /**
+             * @struct Samples
+             * @brief Dernières durées d'un type de commande.
+             */
+            struct Samples
+            {
+                quint64 count = 0;/**< Nombre total de commandes */
+                QVector<qint64> durations;/**< Tampon circulaire des #PERF_SAMPLES dernières durées (ms) */
+            };
+
+            /**
+             * @struct Busy
+             * @brief Durée d'une commande terminée, pour le calcul de l'occupation.
+             */
+            struct Busy
+            {
+                qint64 end;/**< Fin de la commande (ms, voir PerfDock::m_clock) */
+                qint64 elapsed;/**< Durée de la commande (ms) */
+            };
+
+            /**
+             * @struct CpuSample
+             * @brief Temps CPU consommé à une date donnée.
+             */
+            struct CpuSample
+            {
+                qint64 wall;/**< Date (ms, voir PerfDock::m_clock) */
+                qint64 cpu;/**< Temps CPU cumulé (ms) */
+            };
+
+            static qint64 percentile(QVector<qint64> values, double p);
+            static qint64 cpuTime();
+
+        private:
+            Ui::PerfDock *ui;/**< UI de la classe PerfDock */
+            QTimer m_timer;/**< Mise à jour périodique des statistiques */
+            QElapsedTimer m_clock;/**< Origine des dates */
+            QQueue<Invocation> m_recent;/**< #PERF_RECENT dernières commandes, la plus récente en tête */
+            QHash<QString, Samples> m_samples;/**< Durées par type de commande */
+            QQueue<Busy> m_busy;/**< Commandes terminées dans la fenêtre #PERF_WINDOW_MS */
+            QQueue<CpuSample> m_cpu;/**< Temps CPU dans la fenêtre #PERF_WINDOW_MS */
+            bool m_bDirty;/**< Des commandes ont été reçues depuis la dernière mise à jour */
+    };
+
+#endif // PERFDOCK_HPP
@@ -3,6 +3,8 @@
 
     #include <QMainWindow>
 
+    #include "RefSnapshot.hpp"
+
     namespace Ui {
     class TagsWindow;
     }
@@ -20,12 +22,12 @@
         Q_OBJECT
 
         public:
-            TagsWindow(QWidget *parent = nullptr, QStringList tags = QStringList());
+            TagsWindow(QWidget *parent = nullptr, const RefSnapshot& refs = RefSnapshot());
             ~TagsWindow();
 
         public slots:
             void clean_tag_name();
-            void update_tags(QStringList tags);
+            void update_tags(const RefSnapshot& refs);
 
         signals:
             /**
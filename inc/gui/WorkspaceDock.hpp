@@ -0,0 +1,49 @@
+#ifndef WORKSPACEDOCK_HPP
+#define WORKSPACEDOCK_HPP
+
+    #include <QDockWidget>
+    #include "Workspace.hpp"
+
+    namespace Ui {
+        class WorkspaceDock;
+    }
+
+    /**
+     * @class WorkspaceDock
+     * @brief La classe WorkspaceDock affiche les dépôts de l'espace de travail.
+     *
+     * Une ligne par dépôt : branche, nombre de fichiers indexés, modifiés, non
+     * suivis et en conflit, avance et retard sur la branche amont. Le dépôt au
+     * premier plan est affiché en gras. Un double-clic sur un dépôt demande son
+     * affichage dans la fenêtre principale.@n
+     * Header : WorkspaceDock.hpp
+     */
+    class WorkspaceDock : public QDockWidget
+    {
+        Q_OBJECT
+
+        public:
+            WorkspaceDock(Workspace* workspace, QWidget *parent = nullptr);
+            ~WorkspaceDock();
+
+        signals:
+            /**
+             * @param path Dossier du dépôt
+             *
+             * Ce signal est émit pour afficher un dépôt dans la fenêtre principale.
+             */
+            void open(const QString& path);
+
+        private slots:
+            void workspace_changed();
+            void workspace_updated(int index);
+            void on_pushButton_add_clicked();
+            void on_pushButton_remove_clicked();
+            void on_tableWidget_repos_cellDoubleClicked(int row, int column);
+
+        private:
+            Ui::WorkspaceDock *ui;/**< UI de la classe WorkspaceDock */
+            Workspace* m_workspace;/**< Dépôts affichés */
+    };
+
+#endif // WORKSPACEDOCK_HPP
@@ -2,12 +2,18 @@
 #define CONTEXT_HPP
 
     #include <QString>
+    #include <QStringList>
 
     class Context
     {
         private:
             Context();
 
+        public:
+            // Utilisation d'une fonctionnalité optionnelle de Git : "false", "true"
+            // ou "auto" (configuration du dépôt) dans le fichier INI
+            enum Feature { Off, On, Auto };
+
         public:
             static Context* Instance();
             void save();
@@ -17,15 +23,68 @@
             bool timer() const                          { return m_bTimerAuto;      }
             void setTimerTime(int seconds)              { m_timerRefresh = seconds; }
             int timerTime() const                       { return m_timerRefresh;    }
+            void setWatch(bool enable)                  { m_bWatch = enable;        }
+            bool watch() const                          { return m_bWatch;          }
+            void setWatchWorkTree(bool enable)          { m_bWatchWorkTree = enable; }
+            bool watchWorkTree() const                  { return m_bWatchWorkTree;  }
+            void setMaxStaleness(int seconds)           { m_maxStaleness = seconds; }
+            int maxStaleness() const                    { return m_maxStaleness;    }
+            void setProcessPool(int size)               { m_processPool = size;     }
+            int processPool() const                     { return m_processPool;     }
+            void setLogLevel(int level)                 { m_logLevel = level;       }
+            int logLevel() const                        { return m_logLevel;        }
+            void setLogMaxSize(int kb)                  { m_logMaxSize = kb;        }
+            int logMaxSize() const                      { return m_logMaxSize;      }
+            void setLogMaxAge(int hours)                { m_logMaxAge = hours;      }
+            int logMaxAge() const                       { return m_logMaxAge;       }
+            void setLogRetention(int count)             { m_logRetention = count;   }
+            int logRetention() const                    { return m_logRetention;    }
+            void setLogBinary(bool enable)              { m_bLogBinary = enable;    }
+            bool logBinary() const                      { return m_bLogBinary;      }
+            void setTimeoutQuery(int seconds)           { m_timeoutQuery = seconds; }
+            int timeoutQuery() const                    { return m_timeoutQuery;    }
+            void setTimeoutLocal(int seconds)           { m_timeoutLocal = seconds; }
+            int timeoutLocal() const                    { return m_timeoutLocal;    }
+            void setTimeoutNetwork(int seconds)         { m_timeoutNetwork = seconds; }
+            int timeoutNetwork() const                  { return m_timeoutNetwork;  }
+            void setWorkspace(const QStringList& repos) { m_workspace = repos;      }
+            const QStringList& workspace() const        { return m_workspace;       }
+            void setDeferredStartup(bool enable)        { m_bDeferredStartup = enable; }
+            bool deferredStartup() const                { return m_bDeferredStartup; }
+            void setUntrackedTime(int seconds)          { m_untrackedRefresh = seconds; }
+            int untrackedTime() const                   { return m_untrackedRefresh; }
+            void setUntrackedCache(Feature mode)        { m_untrackedCache = mode;  }
+            Feature untrackedCache() const              { return m_untrackedCache;  }
+            void setFsmonitor(Feature mode)             { m_fsmonitor = mode;       }
+            Feature fsmonitor() const                   { return m_fsmonitor;       }
 
         private:
             void init();
+            static Feature parseFeature(const QString& value);
+            static const char* featureName(Feature mode);
 
         private:
             static Context* m_instance;
             QString m_currentGitDir;
             bool m_bTimerAuto;
             int m_timerRefresh;
+            int m_processPool;
+            int m_maxStaleness;
+            int m_logLevel;
+            int m_logMaxSize;
+            int m_logMaxAge;
+            int m_logRetention;
+            bool m_bLogBinary;
+            int m_timeoutQuery;
+            int m_timeoutLocal;
+            int m_timeoutNetwork;
+            QStringList m_workspace;
+            bool m_bDeferredStartup;
+            int m_untrackedRefresh;
+            Feature m_untrackedCache;
+            Feature m_fsmonitor;
+            bool m_bWatch;
+            bool m_bWatchWorkTree;
     };
 
     #define qCtx Context::Instance()
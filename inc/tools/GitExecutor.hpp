@@ -0,0 +1,217 @@
+#ifndef GITEXECUTOR_HPP
+#define GITEXECUTOR_HPP
+
+    #include <QObject>
+    #include <QProcess>
+    #include <QProcessEnvironment>
+    #include <QQueue>
+    #include <QStringList>
+    #include <QElapsedTimer>
+    #include <QMetaType>
+    #include <QTimer>
+
+    #define GIT_MIN_PARALLEL    2       /**< Nombre minimal de processus : un pour la file principale, un pour la basse priorité */
+    #define GIT_STREAM_CAP      (4 * 1024 * 1024)   /**< Taille maximale conservée de la sortie d'une commande en flux (octets) */
+    #define GIT_TIMEOUT_QUERY   60      /**< Délai maximal par défaut d'une commande en lecture seule (s) */
+    #define GIT_TIMEOUT_LOCAL   300     /**< Délai maximal par défaut d'une commande locale (s) */
+    #define GIT_TIMEOUT_NETWORK 900     /**< Délai maximal par défaut d'une commande réseau (s) */
+
+    /**
+     * @struct GitResult
+     * @brief Résultat d'exécution d'une commande Git.
+     *
+     * Header : GitExecutor.hpp
+     */
+    struct GitResult
+    {
+        QStringList args;/**< Arguments de la commande */
+        QString workingDirectory;/**< Dossier d'exécution */
+        QByteArray output;/**< Sortie standard (début seulement si GitResult::truncated) */
+        QByteArray error;/**< Erreur standard */
+        qint64 outputSize = 0;/**< Taille totale de la sortie standard (octets) */
+        bool truncated = false;/**< La sortie dépasse la taille conservée (voir GitExecutor::stream) */
+        bool canceled = false;/**< La commande a été annulée (voir GitJob::cancel) */
+        bool timedOut = false;/**< La commande a dépassé son délai maximal */
+        int exitCode = -1;/**< Code retour (-1 si le processus n'a pas terminé normalement) */
+        qint64 waited = 0;/**< Temps passé dans la file d'attente (ms) */
+        qint64 elapsed = 0;/**< Durée d'exécution du processus (ms) */
+
+        bool success() const        { return exitCode == 0;                 }
+        QString outputText() const  { return QString::fromUtf8(output);     }
+        QString errorText() const   { return QString::fromUtf8(error);      }
+    };
+    Q_DECLARE_METATYPE(GitResult)
+
+    /**
+     * @class GitJob
+     * @brief La classe GitJob représente une commande Git mise en file d'attente.
+     *
+     * Un GitJob est créé par GitExecutor::execute et se détruit de lui même après
+     * l'émission de ses signaux de fin. Il permet d'annuler la commande, qu'elle
+     * soit en attente ou en cours.@n
+     * L'erreur standard est lue au fil de l'exécution : les lignes de
+     * progression de Git (option @c --progress) sont transmises par le signal
+     * GitJob::progress et seule leur dernière valeur est conservée dans
+     * GitResult::error.@n
+     * Header : GitExecutor.hpp
+     */
+    class GitJob : public QObject
+    {
+        Q_OBJECT
+
+        friend class GitExecutor;
+
+        public:
+            const QStringList& args() const     { return m_result.args;     }
+            bool isRunning() const              { return m_process != nullptr; }
+            const GitResult& result() const     { return m_result;          }
+            void cancel();
+
+        signals:
+            /**
+             * Ce signal est émit au lancement du processus Git.
+             */
+            void started();
+            /**
+             * @param result Résultat de la commande
+             *
+             * Ce signal est émit à la fin de la commande, quel que soit son code retour.
+             */
+            void finished(const GitResult& result);
+            /**
+             * @param result Résultat de la commande
+             *
+             * Ce signal est émit après GitJob::finished si la commande a réussi.
+             */
+            void succeeded(const GitResult& result);
+            /**
+             * @param result Résultat de la commande
+             *
+             * Ce signal est émit après GitJob::finished si la commande a échoué.
+             */
+            void failed(const GitResult& result);
+            /**
+             * @param chunk Partie de la sortie standard
+             *
+             * Ce signal est émit à chaque réception d'une partie de la sortie
+             * standard, pour les commandes lancées par GitExecutor::stream.
+             */
+            void outputReady(const QByteArray& chunk);
+            /**
+             * @param phase Etape en cours (ex : "Receiving objects")
+             * @param percent Avancement de l'étape (0 à 100)
+             *
+             * Ce signal est émit à chaque ligne de progression écrite par Git.
+             */
+            void progress(const QString& phase, int percent);
+
+        private:
+            GitJob(const QString& dir, const QStringList& args, int mode, QObject* parent);
+            void readOutput();
+            void readError();
+            void parseProgress(const QByteArray& line);
+
+        private:
+            GitResult m_result;/**< Résultat en cours de construction */
+            int m_mode;/**< Type d'accès au dépôt (voir GitExecutor::Mode) */
+            bool m_bBackground;/**< Commande de basse priorité (voir GitExecutor::background) */
+            bool m_bOptionalLocks;/**< La commande en lecture seule peut réécrire l'index (verrous optionnels de Git) */
+            QProcess* m_process;/**< Processus Git (nul tant que le job n'est pas lancé) */
+            QElapsedTimer m_clock;/**< Chronomètre attente/exécution */
+            qint64 m_traceStart;/**< Début de la phase en cours (voir Tracer::now) */
+            qint64 m_streamCap;/**< Taille maximale conservée de la sortie en flux (-1 : sortie lue à la fin) */
+            QByteArray m_errorLine;/**< Dernière ligne incomplète de l'erreur standard */
+            QTimer m_timeout;/**< Délai maximal d'exécution */
+    };
+
+    /**
+     * @class GitExecutor
+     * @brief La classe GitExecutor exécute les commandes Git sans bloquer l'IHM.
+     *
+     * Les commandes sont placées dans une file d'attente et exécutées dans l'ordre
+     * de leur demande. La fin de chaque commande est notifiée par les signaux du
+     * GitJob associé.@n
+     * Les commandes en lecture seule consécutives sont exécutées en parallèle dans
+     * la limite de GitExecutor::maxParallel processus, de même que les commandes
+     * GitExecutor::Concurrent consécutives. Une commande d'écriture attend la fin
+     * des commandes en cours dans son dossier et s'y exécute seule ; les
+     * commandes sur d'autres dépôts ne la retardent pas.@n
+     * Les commandes de basse priorité (GitExecutor::background) ont leur propre
+     * file : elles ne sont lancées que si la file principale est vide et
+     * laissent toujours un processus libre pour elle. Le nombre de processus
+     * est donc au moins #GIT_MIN_PARALLEL.@n
+     * Header : GitExecutor.hpp
+     */
+    class GitExecutor : public QObject
+    {
+        Q_OBJECT
+
+        public:
+            /**
+             * @enum Mode
+             * @brief Type d'accès au dépôt d'une commande.
+             */
+            enum Mode {
+                Write,/**< La commande peut modifier le dépôt : exécution exclusive */
+                ReadOnly,/**< La commande ne fait que lire le dépôt : exécution parallèle possible */
+                Concurrent/**< La commande ne modifie que ses propres références (fetch d'un dépôt distant) : exécution parallèle avec les autres commandes Concurrent */
+            };
+            /**
+             * @enum CommandClass
+             * @brief Classe de commande, pour le délai maximal d'exécution.
+             */
+            enum CommandClass {
+                Query,/**< Commande en lecture seule */
+                Local,/**< Commande modifiant le dépôt local */
+                Network/**< Commande accédant à un dépôt distant (push, fetch, ...) */
+            };
+
+        private:
+            GitExecutor();
+
+        public:
+            static GitExecutor* Instance();
+            GitJob* execute(const QString& dir, const QStringList& args, Mode mode = Write);
+            GitJob* stream(const QString& dir, const QStringList& args, Mode mode = Write, qint64 cap = GIT_STREAM_CAP);
+            GitJob* background(const QString& dir, const QStringList& args, bool b_optionalLocks = false);
+            void clear();
+            void setMaxParallel(int n);
+            void cancel(GitJob* job);
+            void cancelQueries(const QString& dir);
+            static CommandClass commandClass(const QStringList& args, Mode mode);
+            static QString commandName(const QStringList& args);
+            bool versionAtLeast(int major, int minor);
+            void setTimeout(CommandClass commandClass, int seconds);
+            int timeout(CommandClass commandClass) const    { return m_timeouts[commandClass]; }
+            int maxParallel() const     { return m_maxParallel;     }
+            int pending() const         { return m_queue.length();  }
+            int running() const         { return m_running.length(); }
+
+        signals:
+            /**
+             * @param result Résultat de la commande
+             *
+             * Ce signal est émit à la fin de chaque commande exécutée.
+             */
+            void jobFinished(const GitResult& result);
+
+        private:
+            void schedule();
+            void start(GitJob* job);
+            void requeue(GitJob* job);
+            void finish(GitJob* job);
+
+        private:
+            static GitExecutor* m_instance;
+            QQueue<GitJob*> m_queue;/**< Commandes en attente */
+            QQueue<GitJob*> m_background;/**< Commandes de basse priorité en attente */
+            QList<GitJob*> m_running;/**< Commandes en cours d'exécution */
+            int m_maxParallel;/**< Nombre maximal de commandes en lecture seule simultanées */
+            QProcessEnvironment m_readOnlyEnv;/**< Environnement des commandes en lecture seule */
+            int m_timeouts[3];/**< Délai maximal de chaque classe de commande (s, 0 : aucun) */
+            int m_version;/**< Version de Git (majeure * 1000 + mineure, -1 : non lue, 0 : inconnue) */
+    };
+
+    #define qGit GitExecutor::Instance()
+
+#endif // GITEXECUTOR_HPP
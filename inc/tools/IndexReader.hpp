@@ -0,0 +1,127 @@
+#ifndef INDEXREADER_HPP
+#define INDEXREADER_HPP
+
+    #include <QByteArray>
+    #include <QFile>
+    #include <QStringList>
+    #include <QVector>
+
+    #define INDEX_OID_SIZE      20      /**< Taille d'un identifiant d'objet SHA-1 */
+    #define INDEX_OID_FORMAT    "sha1"  /**< Format des identifiants d'objet supporté */
+
+    /**
+     * @struct IndexEntry
+     * @brief Entrée du fichier @c index de Git.
+     *
+     * L'entrée ne contient aucune copie : les champs sont lus à la demande dans
+     * l'enregistrement projeté en mémoire par IndexReader. Elle n'est valide que
+     * tant que le lecteur reste ouvert.@n
+     * Header : IndexReader.hpp
+     */
+    struct IndexEntry
+    {
+        /**
+         * @enum ExtendedFlag
+         * @brief Drapeaux étendus (index version 3 et plus).
+         */
+        enum ExtendedFlag : quint16 {
+            IntentToAdd = 0x2000,/**< Fichier ajouté par @b git @b add @b -N */
+            SkipWorktree = 0x4000/**< Fichier exclu de la copie de travail */
+        };
+
+        const uchar* record;/**< Début de l'enregistrement dans le fichier projeté */
+        const char* path;/**< Chemin (non terminé par un caractère nul en version 4) */
+        int pathLength;/**< Longueur du chemin */
+        quint16 flags;/**< Drapeaux (stage, longueur du nom) */
+        quint16 extended;/**< Drapeaux étendus, combinaison de IndexEntry::ExtendedFlag */
+
+        quint32 mtime() const           { return be32(8);   }
+        quint32 mtimeNsec() const       { return be32(12);  }
+        quint32 mode() const            { return be32(24);  }
+        quint32 size() const            { return be32(36);  }
+        const uchar* oid() const        { return record + 40; }
+        QByteArray oidHex() const       { return QByteArray::fromRawData(reinterpret_cast<const char*>(oid()), INDEX_OID_SIZE).toHex(); }
+        int stage() const               { return (flags >> 12) & 0x3; }
+        bool isIntentToAdd() const      { return extended & IntentToAdd; }
+
+        /**
+         * @param offset Position dans l'enregistrement
+         * @return Entier 32 bits (gros-boutiste) lu à la position @c offset
+         */
+        quint32 be32(int offset) const
+        {
+            const uchar* p = record + offset;
+            return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+        }
+    };
+
+    /**
+     * @class IndexReader
+     * @brief La classe IndexReader lit le fichier @c index d'un dépôt Git.
+     *
+     * Le fichier est projeté en mémoire (QFile::map) et analysé sans copie : les
+     * versions 2, 3 et 4 (compression des préfixes de chemin) sont supportées.
+     * Les extensions sont repérées : @c TREE fournit l'arbre racine en cache,
+     * @c UNTR et @c FSMN indiquent la présence du cache des fichiers non suivis
+     * et de fsmonitor.@n
+     * Un index partagé (extension @c link) ou creux (extension @c sdir) n'est
+     * pas supporté : IndexReader::open échoue avec IndexReader::Unsupported et
+     * l'appelant doit passer par la ligne de commande Git. Il en va de même pour
+     * un dépôt dont les objets ne sont pas identifiés en SHA-1
+     * (@c extensions.objectformat, voir IndexReader::objectFormat).@n
+     * Git remplace l'index par renommage : le fichier projeté n'est jamais
+     * modifié pendant la lecture. Sous Windows la projection empêche ce
+     * renommage, le lecteur doit donc être fermé dès la lecture terminée.@n
+     * Header : IndexReader.hpp
+     */
+    class IndexReader
+    {
+        public:
+            /**
+             * @enum Error
+             * @brief Erreur de lecture.
+             */
+            enum Error {
+                NoError,/**< Lecture réussie */
+                OpenError,/**< Fichier absent ou illisible */
+                FormatError,/**< Fichier corrompu */
+                Unsupported/**< Version ou extension non supportée */
+            };
+
+        public:
+            IndexReader();
+            ~IndexReader();
+            static QString objectFormat(const QString& commonDir);
+            bool open(const QString& path, const QString& objectFormat = INDEX_OID_FORMAT);
+            void close();
+            bool isOpen() const                             { return m_data != nullptr; }
+            Error error() const                             { return m_error;       }
+            QString errorString() const                     { return m_errorString; }
+            int version() const                             { return m_version;     }
+            const QVector<IndexEntry>& entries() const      { return m_entries;     }
+            QByteArray checksum() const;
+            QByteArray rootTree() const;
+            const QStringList& extensions() const           { return m_extensions;  }
+            bool hasUntrackedCache() const                  { return m_extensions.contains("UNTR"); }
+            bool hasFsmonitor() const                       { return m_extensions.contains("FSMN"); }
+
+        private:
+            bool fail(Error error, const QString& message);
+            bool parseEntries(int count, qint64& pos);
+            bool parseExtensions(qint64 pos);
+            void parseTree(const uchar* data, quint32 size);
+
+        private:
+            QFile m_file;/**< Fichier index */
+            const uchar* m_data;/**< Fichier projeté en mémoire */
+            qint64 m_size;/**< Taille du fichier */
+            int m_version;/**< Version du format (2, 3 ou 4) */
+            Error m_error;/**< Dernière erreur */
+            QString m_errorString;/**< Description de la dernière erreur */
+            QVector<IndexEntry> m_entries;/**< Entrées de l'index */
+            QByteArray m_paths;/**< Chemins reconstruits (version 4 uniquement) */
+            QStringList m_extensions;/**< Signatures des extensions présentes */
+            qint64 m_rootTree;/**< Position de l'arbre racine de l'extension TREE (-1 si absent) */
+    };
+
+#endif // INDEXREADER_HPP
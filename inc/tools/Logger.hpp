@@ -4,7 +4,59 @@
     #include <QString>
     #include <QFile>
     #include <QTextStream>
+    #include <QThread>
+    #include <QMutex>
+    #include <QWaitCondition>
+    #include <QAtomicInt>
+    #include <QAtomicInteger>
+    #include <QStringList>
+    #include <QHash>
+    #include <QDataStream>
+    #include <QDateTime>
 
+    #define LOG_RING_SIZE       8192    /**< Nombre d'enregistrements en attente d'écriture (puissance de 2) */
+    #define LOG_BINARY_MAGIC    "GLOG"  /**< Signature des journaux binaires */
+    #define LOG_BINARY_VERSION  1       /**< Version du format binaire */
+    #define LOG_BINARY_HEADER   15      /**< Taille de l'en-tête d'un enregistrement binaire */
+
+    #ifndef LOG_MIN_LEVEL
+        /**
+         * Niveau minimal compilé (voir Logger::LogLevel). Les appels de niveau
+         * inférieur sont supprimés à la compilation, par exemple avec
+         * @c DEFINES+=LOG_MIN_LEVEL=1 pour retirer les messages de debug.
+         */
+        #define LOG_MIN_LEVEL 0
+    #endif
+
+    /**
+     * @class Logger
+     * @brief La classe Logger écrit le journal de l'application.
+     *
+     * Les messages sont formatés par l'appelant puis déposés dans un tampon
+     * circulaire de #LOG_RING_SIZE enregistrements, sans verrou : plusieurs
+     * threads peuvent écrire en même temps. Un thread dédié vide le tampon par
+     * lots et écrit le fichier, qui n'est vidé sur disque qu'une fois par lot.
+     * Les messages déposés avant le premier Logger::createLog sont conservés
+     * dans le tampon et écrits à l'ouverture du fichier.@n
+     * Si le tampon est plein, le message est abandonné et compté : le nombre de
+     * messages perdus est écrit dans le journal dès que possible. La fonction
+     * Logger::close écrit tous les messages en attente avant de fermer le
+     * fichier.@n
+     * Les mots clés (Logger::addKeyWord) sont propres à chaque thread.@n
+     * Le journal est écrit en UTF-8, ou au format binaire (Logger::Binary) :
+     * signature #LOG_BINARY_MAGIC, version sur un octet, puis pour chaque
+     * message la date (qint64, ms depuis l'epoch), le niveau (quint8), la taille
+     * des mots clés (quint16), la taille du texte (quint32), les mots clés et le
+     * texte en UTF-8. Les entiers sont big-endian (QDataStream). L'outil
+     * GitIHMLogDump relit ce format.@n
+     * Le fichier est renommé (@c .1, @c .2, ...) dès qu'il dépasse la taille ou
+     * l'âge configurés par Logger::setRotation, en conservant un nombre limité
+     * d'anciens fichiers.@n
+     * Un message est filtré avant tout formatage s'il est sous le niveau minimal
+     * compilé (#LOG_MIN_LEVEL), sous le niveau minimal courant
+     * (Logger::setMinLevel) ou sous le niveau associé à l'un des mots clés du
+     * thread (Logger::setKeywordLevel).
+     */
     class Logger
     {
         public:
@@ -15,35 +67,118 @@
                 Error,
                 Fatal
             };
+            enum Format {
+                Text,
+                Binary
+            };
 
         private:
             Logger();
 
         public:
             static Logger* Instance();
-            void createLog(const QString& fileName, bool overwrite = false);
+            void setRotation(qint64 maxBytes, int maxAge, int retention);
+            void createLog(const QString& fileName, bool overwrite = false, Format format = Text);
             void close();
             void addKeyWord(const QString& kw);
             void removeKeyWord();
-            template<class ...Args> void debug(Args... args) { reset(); log(Debug, args...); }
-            template<class ...Args> void info(Args... args) { reset(); log(Info, args...); }
-            template<class ...Args> void warning(Args... args) { reset(); log(Warning, args...); }
-            template<class ...Args> void error(Args... args) { reset(); log(Error, args...); }
-            template<class ...Args> void fatal(Args... args) { reset(); log(Fatal, args...); }
+            quint64 dropped() const                             { return quint64(m_dropped.load()); }
+            void setMinLevel(LogLevel lvl)                      { m_minLevel.store(lvl);    }
+            LogLevel minLevel() const                           { return LogLevel(m_minLevel.load()); }
+            void setKeywordLevel(const QString& kw, LogLevel lvl);
+            void clearKeywordLevels();
+            /**
+             * @param lvl Niveau du message
+             * @return @c true si un message de ce niveau serait écrit
+             *
+             * Le test du niveau compilé est résolu à la compilation, celui du niveau
+             * courant ne coûte qu'une lecture atomique. Les mots clés ne sont
+             * consultés que si un filtre par mot clé existe.
+             */
+            bool isEnabled(LogLevel lvl) const
+            {
+                return lvl >= LOG_MIN_LEVEL && lvl >= m_minLevel.load() && m_bOpen.load() &&
+                       (m_keywordFilters.load() == 0 || keywordAllows(lvl));
+            }
+            template<class ...Args> void debug(const Args&... args)     { if(isEnabled(Debug)) log(Debug, args...);     }
+            template<class ...Args> void info(const Args&... args)      { if(isEnabled(Info)) log(Info, args...);       }
+            template<class ...Args> void warning(const Args&... args)   { if(isEnabled(Warning)) log(Warning, args...); }
+            template<class ...Args> void error(const Args&... args)     { if(isEnabled(Error)) log(Error, args...);     }
+            template<class ...Args> void fatal(const Args&... args)     { if(isEnabled(Fatal)) log(Fatal, args...);     }
 
         private:
-            void reset();
-            void printInfo(LogLevel lvl);
-            template<class T> void log(LogLevel lvl, const T& t) { m_buffer << t; printInfo(lvl); }
-            template<class T, class ...Args> void log(LogLevel lvl, const T& t, Args... args) { m_buffer << t << ' '; log(lvl, args...); }
+            /**
+             * @struct Record
+             * @brief Message en attente d'écriture.
+             */
+            struct Record
+            {
+                QAtomicInteger<quint32> sequence;/**< Numéro de tour, synchronise producteurs et écrivain */
+                qint64 time;/**< Date du message (ms depuis l'epoch) */
+                LogLevel level;/**< Niveau du message */
+                QString keywords;/**< Mots clés du thread producteur */
+                QString text;/**< Message formaté */
+            };
+
+            /**
+             * @class Writer
+             * @brief Thread d'écriture du journal.
+             */
+            class Writer : public QThread
+            {
+                public:
+                    Writer(Logger* logger) : m_logger(logger) {}
+                protected:
+                    void run() override                     { m_logger->writerLoop(); }
+                private:
+                    Logger* m_logger;/**< Journal à écrire */
+            };
+
+            template<class ...Args> void log(LogLevel lvl, const Args&... args)
+            {
+                QString output;
+                QTextStream buffer(&output, QIODevice::WriteOnly);
+                format(buffer, args...);
+                buffer.flush();
+                push(lvl, output);
+            }
+            template<class T> void format(QTextStream& buffer, const T& t) { buffer << t; }
+            template<class T, class ...Args> void format(QTextStream& buffer, const T& t, const Args&... args) { buffer << t << ' '; format(buffer, args...); }
+            bool keywordAllows(LogLevel lvl) const;
+            bool openFile(bool overwrite);
+            bool needsRotation() const;
+            void rotate();
+            void rotateFiles();
+            void flush();
+            void push(LogLevel lvl, const QString& message);
+            void writerLoop();
+            int drain();
+            void write(const Record& record);
 
         private:
-            static Logger* m_instance;
-            QTextStream m_buffer;
-            QString m_output;
+            Record m_ring[LOG_RING_SIZE];/**< Tampon circulaire des messages */
+            QAtomicInteger<quint32> m_head;/**< Prochaine position d'écriture des producteurs */
+            quint32 m_tail;/**< Prochaine position de lecture de l'écrivain */
+            QAtomicInt m_dropped;/**< Nombre de messages perdus (tampon plein) */
+            int m_reported;/**< Nombre de messages perdus déjà signalés dans le journal */
+            QAtomicInt m_bOpen;/**< Le journal accepte des messages */
+            QAtomicInt m_bStop;/**< Arrêt demandé au thread d'écriture */
+            QAtomicInt m_minLevel;/**< Niveau minimal courant */
+            QAtomicInt m_keywordFilters;/**< Nombre de filtres par mot clé */
+            QAtomicInt m_filterGeneration;/**< Incrémenté à chaque modification des filtres par mot clé */
+            mutable QMutex m_filterMutex;/**< Protège m_keywordLevels */
+            QHash<QString, int> m_keywordLevels;/**< Niveau minimal associé à chaque mot clé */
+            QMutex m_wakeMutex;/**< Protège l'attente du thread d'écriture */
+            QWaitCondition m_wake;/**< Réveil du thread d'écriture */
+            Writer* m_writer;/**< Thread d'écriture */
             QFile m_logFile;
             QTextStream m_logStream;
-            QStringList m_kw;
+            QDataStream m_binaryStream;/**< Ecriture au format binaire */
+            Format m_format;/**< Format du fichier */
+            qint64 m_maxBytes;/**< Taille maximale du fichier (0 : illimitée) */
+            int m_maxAge;/**< Age maximal du fichier en secondes (0 : illimité) */
+            int m_retention;/**< Nombre d'anciens fichiers conservés */
+            QDateTime m_created;/**< Date de création du fichier courant */
     };
 
     #define qLog Logger::Instance()
@@ -0,0 +1,56 @@
+#ifndef REFREADER_HPP
+#define REFREADER_HPP
+
+    #include <QDateTime>
+    #include <QHash>
+    #include <QString>
+    #include <QStringList>
+
+    #include "RefSnapshot.hpp"
+    #include "RepoFingerprint.hpp"
+
+    /**
+     * @class RefReader
+     * @brief La classe RefReader lit les références d'un dépôt sans lancer de
+     * processus.
+     *
+     * Les références sont lues dans @c packed-refs (projeté en mémoire) puis dans
+     * les fichiers individuels de @c refs, qui sont prioritaires. HEAD est
+     * résolue pour repérer la branche courante et les branches amont sont lues
+     * dans le fichier @c config.@n
+     * Le résultat est conservé tant que l'empreinte des références (voir
+     * RepoFingerprint) et la date du fichier @c config sont inchangées.@n
+     * Le stockage @c reftable n'est pas supporté, ni le calcul d'avance/retard
+     * sur les branches amont : l'appelant passe alors par @b git @b for-each-ref.@n
+     * Header : RefReader.hpp
+     */
+    class RefReader
+    {
+        public:
+            RefReader();
+            void setRepository(const QString& gitDir, const QString& commonDir);
+            bool read(RefSnapshot& snapshot);
+            bool isSupported() const;
+            bool lastReadCached() const                 { return m_bCached;     }
+            QStringList configRemotes();
+            void clear();
+
+        private:
+            void readConfig();
+            bool readPacked(QVector<RefRecord>& records, QHash<QString, int>& names) const;
+            void readLoose(QVector<RefRecord>& records, QHash<QString, int>& names) const;
+            QString readHead() const;
+
+        private:
+            QString m_gitDir;/**< Dossier Git du dépôt (HEAD) */
+            QString m_commonDir;/**< Dossier Git commun (refs, packed-refs, config) */
+            RepoFingerprint m_stamp;/**< Empreinte des références lors de la dernière lecture */
+            QDateTime m_configStamp;/**< Date du fichier config lors de la dernière lecture */
+            QStringList m_remotes;/**< Dépôts distants déclarés dans config */
+            QHash<QString, QString> m_upstreams;/**< Branche amont (nom complet) de chaque branche locale */
+            RefSnapshot m_snapshot;/**< Dernière lecture */
+            bool m_bValid;/**< La dernière lecture est utilisable */
+            bool m_bCached;/**< La dernière lecture a été servie par le cache */
+    };
+
+#endif // REFREADER_HPP
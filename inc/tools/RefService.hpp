@@ -0,0 +1,46 @@
+#ifndef REFSERVICE_HPP
+#define REFSERVICE_HPP
+
+    #include <QObject>
+    #include "RefSnapshot.hpp"
+    #include "GitExecutor.hpp"
+    #include "RefReader.hpp"
+
+    /**
+     * @class RefService
+     * @brief La classe RefService maintient la liste des références d'un dépôt.
+     *
+     * Les branches, tags et branches distantes sont lus directement dans les
+     * fichiers du dépôt (voir RefReader). Si ce n'est pas possible, ou si
+     * l'avance/retard sur les branches amont est demandé, ils sont obtenus par
+     * une unique commande @b git @b for-each-ref. Les dépôts distants déclarés
+     * dans le fichier @c config mais jamais récupérés sont ajoutés à la liste.@n
+     * Header : RefService.hpp
+     */
+    class RefService : public QObject
+    {
+        Q_OBJECT
+
+        public:
+            RefService(QObject* parent = nullptr);
+            void setRepository(const QString& workDir, const QString& gitDir, const QString& commonDir);
+            void setTracking(bool enable)               { m_bTracking = enable; }
+            GitJob* refresh();
+            const RefSnapshot& snapshot() const         { return m_snapshot;    }
+
+        signals:
+            /**
+             * @param snapshot Nouvelle liste des références
+             *
+             * Ce signal est émit à chaque mise à jour réussie des références.
+             */
+            void updated(const RefSnapshot& snapshot);
+
+        private:
+            RefSnapshot m_snapshot;/**< Dernière liste des références */
+            QString m_workDir;/**< Dossier d'exécution des commandes */
+            RefReader m_reader;/**< Lecture des références sans processus */
+            bool m_bTracking;/**< Calcul de l'avance/retard sur les branches amont */
+    };
+
+#endif // REFSERVICE_HPP
@@ -0,0 +1,70 @@
+#ifndef REFSNAPSHOT_HPP
+#define REFSNAPSHOT_HPP
+
+    #include <QByteArray>
+    #include <QString>
+    #include <QStringList>
+    #include <QVector>
+    #include <QMetaType>
+
+    /**
+     * @struct RefRecord
+     * @brief Référence Git (branche, tag ou branche distante).
+     *
+     * Header : RefSnapshot.hpp
+     */
+    struct RefRecord
+    {
+        /**
+         * @enum Type
+         * @brief Type de référence.
+         */
+        enum Type : quint8 {
+            Branch,/**< Branche locale (refs/heads) */
+            Tag,/**< Tag (refs/tags) */
+            RemoteBranch,/**< Branche distante (refs/remotes) */
+            Other/**< Autre référence (notes, stash...) */
+        };
+
+        Type type = Other;/**< Type de la référence */
+        QString refname;/**< Nom complet (refs/heads/master) */
+        QString name;/**< Nom court (master) */
+        QByteArray oid;/**< Objet pointé */
+        QByteArray peeled;/**< Commit pointé par un tag annoté (vide sinon) */
+        QString upstream;/**< Branche amont (nom complet, vide si aucune) */
+        int ahead = 0;/**< Nombre de commits en avance sur l'amont */
+        int behind = 0;/**< Nombre de commits en retard sur l'amont */
+        bool gone = false;/**< La branche amont n'existe plus */
+        bool head = false;/**< Branche courante */
+    };
+
+    /**
+     * @class RefSnapshot
+     * @brief La classe RefSnapshot contient l'ensemble des références d'un dépôt.
+     *
+     * L'ensemble est obtenu en une seule commande @b git @b for-each-ref (voir
+     * RefSnapshot::queryArgs) et partagé par toutes les fenêtres.@n
+     * Header : RefSnapshot.hpp
+     */
+    class RefSnapshot
+    {
+        public:
+            static QStringList queryArgs(bool tracking = false);
+            static void setRefname(RefRecord& record, const QString& refname);
+            bool parse(const QByteArray& raw);
+            void clear();
+            const QVector<RefRecord>& records() const       { return m_records;     }
+            QVector<RefRecord>& records()                   { return m_records;     }
+            QStringList branches() const;
+            QStringList tags() const;
+            QStringList remotes() const;
+            QString currentBranch() const;
+            void addRemote(const QString& remote);
+
+        private:
+            QVector<RefRecord> m_records;/**< Références du dépôt */
+            QStringList m_extraRemotes;/**< Dépôts distants sans branche connue */
+    };
+    Q_DECLARE_METATYPE(RefSnapshot)
+
+#endif // REFSNAPSHOT_HPP
@@ -0,0 +1,70 @@
+#ifndef REFRESHCOALESCER_HPP
+#define REFRESHCOALESCER_HPP
+
+    #include <QObject>
+    #include <QTimer>
+
+    #define REFRESH_RESOURCES   4       /**< Nombre de ressources (voir RefreshCoalescer::Resource) */
+    #define REFRESH_LOG_PERIOD  100     /**< Nombre de regroupements entre deux bilans dans le log */
+
+    /**
+     * @class RefreshCoalescer
+     * @brief La classe RefreshCoalescer regroupe les demandes de rafraîchissement.
+     *
+     * Les vues ne lancent pas elles-mêmes les requêtes Git : elles déclarent
+     * une ressource invalide grâce à la fonction RefreshCoalescer::request.
+     * Toutes les demandes faites pendant le même tour de boucle d'événements
+     * sont regroupées, puis le signal RefreshCoalescer::flush est émit une
+     * seule fois avec l'union des ressources demandées : chaque ressource
+     * n'est rafraîchie que par une seule commande Git.@n
+     * Les regroupements sont notés dans le log, ainsi qu'un bilan périodique.@n
+     * Header : RefreshCoalescer.hpp
+     */
+    class RefreshCoalescer : public QObject
+    {
+        Q_OBJECT
+
+        public:
+            /**
+             * @enum Resource
+             * @brief Ressource à rafraîchir. Les valeurs de Status et Refs sont
+             * celles de RepoWatcher::Change.
+             */
+            enum Resource {
+                Status = 0x1,/**< Fichiers suivis indexés et modifiés (git status -uno) */
+                Refs = 0x2,/**< Branches, tags et dépôts distants */
+                Stash = 0x4,/**< Liste des stash */
+                Untracked = 0x8,/**< Fichiers non suivis (recherche en basse priorité) */
+                All = Status | Refs | Stash | Untracked/**< Toutes les ressources */
+            };
+
+        public:
+            RefreshCoalescer(QObject* parent = nullptr);
+            void request(int resources);
+            int pending() const     { return m_pending;     }
+
+        signals:
+            /**
+             * @param resources Combinaison de RefreshCoalescer::Resource
+             *
+             * Ce signal est émit au tour de boucle d'événements suivant les
+             * demandes, une seule fois pour toutes les demandes regroupées.
+             */
+            void flush(int resources);
+
+        private slots:
+            void on_timer_timeout();
+
+        private:
+            static const char* name(int index);
+
+        private:
+            QTimer m_timer;/**< Report de l'émission au tour de boucle suivant */
+            int m_pending;/**< Ressources demandées depuis la dernière émission */
+            int m_requests[REFRESH_RESOURCES];/**< Demandes reçues par ressource depuis la dernière émission */
+            qint64 m_totalRequests[REFRESH_RESOURCES];/**< Demandes reçues par ressource depuis le lancement */
+            qint64 m_totalFlushes[REFRESH_RESOURCES];/**< Rafraîchissements émis par ressource depuis le lancement */
+            int m_merges;/**< Nombre d'émissions ayant regroupé plusieurs demandes */
+    };
+
+#endif // REFRESHCOALESCER_HPP
@@ -0,0 +1,37 @@
+#ifndef REPOFINGERPRINT_HPP
+#define REPOFINGERPRINT_HPP
+
+    #include <QString>
+
+    /**
+     * @class RepoFingerprint
+     * @brief La classe RepoFingerprint résume l'état des fichiers Git d'un dépôt.
+     *
+     * L'empreinte est calculée à partir de la taille et de la date de modification
+     * de @c index, @c HEAD, @c packed-refs et des dossiers de @c refs, sans lancer
+     * de processus ni lire le contenu des fichiers. Elle permet de savoir si un
+     * @b git @b status est nécessaire. Les modifications de la copie de travail
+     * qui ne touchent pas l'index ne sont pas détectées.@n
+     * Header : RepoFingerprint.hpp
+     */
+    class RepoFingerprint
+    {
+        public:
+            RepoFingerprint();
+            void setRepository(const QString& gitDir, const QString& commonDir);
+            int update();
+            void reset();
+            quint64 statusStamp() const     { return m_status;  }
+            quint64 refsStamp() const       { return m_refs;    }
+
+        private:
+            static void mix(quint64& hash, const QString& path);
+
+        private:
+            QString m_gitDir;/**< Dossier Git du dépôt */
+            QString m_commonDir;/**< Dossier Git commun */
+            quint64 m_status;/**< Empreinte de l'index et de HEAD */
+            quint64 m_refs;/**< Empreinte de HEAD et des références */
+    };
+
+#endif // REPOFINGERPRINT_HPP
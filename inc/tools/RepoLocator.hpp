@@ -0,0 +1,59 @@
+#ifndef REPOLOCATOR_HPP
+#define REPOLOCATOR_HPP
+
+    #include <QString>
+    #include <QHash>
+
+    /**
+     * @struct RepoLocation
+     * @brief Emplacement des dossiers d'un dépôt Git.
+     *
+     * Header : RepoLocator.hpp
+     */
+    struct RepoLocation
+    {
+        QString gitDir;/**< Dossier Git du dépôt (équivalent de git rev-parse --absolute-git-dir) */
+        QString commonDir;/**< Dossier Git commun aux worktrees (--git-common-dir) */
+        QString workTree;/**< Racine de la copie de travail (--show-toplevel), vide pour un dépôt nu */
+
+        bool isValid() const    { return !gitDir.isEmpty();     }
+        bool isBare() const     { return isValid() && workTree.isEmpty(); }
+    };
+
+    /**
+     * @class RepoLocator
+     * @brief La classe RepoLocator trouve le dépôt Git d'un dossier sans lancer de processus.
+     *
+     * La recherche suit celle de Git, en remontant depuis le dossier :
+     * @li la variable d'environnement @c GIT_DIR (et @c GIT_WORK_TREE) est
+     * prioritaire ;
+     * @li un dossier @c .git désigne un dépôt classique ;
+     * @li un fichier @c .git contenant @c gitdir: désigne un worktree ou un
+     * sous-module, dont le dossier commun est lu dans le fichier @c commondir ;
+     * @li un dossier qui est lui-même un dossier Git est un dépôt nu (ou le
+     * dossier @c .git d'un dépôt), sans copie de travail.
+     *
+     * La remontée s'arrête aux dossiers de @c GIT_CEILING_DIRECTORIES. Un
+     * dossier Git est reconnu à la présence de @c HEAD, @c objects et @c refs.@n
+     * Les résultats sont conservés par dossier demandé. Un résultat n'est
+     * réutilisé que si le fichier @c HEAD de son dossier Git existe toujours ;
+     * les échecs ne sont pas conservés, pour détecter un @b git @b init.@n
+     * Header : RepoLocator.hpp
+     */
+    class RepoLocator
+    {
+        public:
+            bool locate(const QString& path, RepoLocation& location);
+            void clear()            { m_cache.clear();      }
+
+        private:
+            static bool find(const QString& path, RepoLocation& location);
+            static bool isGitDir(const QString& dir);
+            static QString commonDir(const QString& gitDir);
+            static QString readGitFile(const QString& file);
+
+        private:
+            QHash<QString, RepoLocation> m_cache;/**< Dépôts trouvés, par dossier demandé */
+    };
+
+#endif // REPOLOCATOR_HPP
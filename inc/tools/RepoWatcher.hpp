@@ -0,0 +1,92 @@
+#ifndef REPOWATCHER_HPP
+#define REPOWATCHER_HPP
+
+    #include <QObject>
+    #include <QFileSystemWatcher>
+    #include <QTimer>
+    #include <QElapsedTimer>
+    #include <QDateTime>
+    #include <QHash>
+    #include <QSet>
+
+    /**
+     * @class RepoWatcher
+     * @brief La classe RepoWatcher surveille les fichiers d'un dépôt Git.
+     *
+     * Les fichiers @c index, @c HEAD, @c packed-refs et le dossier @c refs sont
+     * surveillés grâce à un QFileSystemWatcher. Les dossiers de la copie de
+     * travail peuvent aussi être surveillés (optionnel), sauf ceux ignorés par
+     * Git (@b git @b ls-files au démarrage, @b git @b check-ignore pour les
+     * nouveaux dossiers). Les notifications sont regroupées pendant un délai de
+     * RepoWatcher::debounce millisecondes avant l'émission du signal
+     * RepoWatcher::changed.@n
+     * Les écritures sur place dans un fichier de la copie de travail ne sont pas
+     * toujours notifiées par le système : le rafraîchissement périodique reste
+     * utile sur les systèmes de fichiers réseau.@n
+     * Header : RepoWatcher.hpp
+     */
+    class RepoWatcher : public QObject
+    {
+        Q_OBJECT
+
+        public:
+            /**
+             * @enum Change
+             * @brief Type de modification détectée.
+             */
+            enum Change {
+                StatusChange = 0x1,/**< L'index ou la copie de travail a changé */
+                RefsChange = 0x2/**< HEAD ou les références ont changé */
+            };
+
+        public:
+            RepoWatcher(QObject* parent = nullptr);
+            void setRepository(const QString& gitDir, const QString& commonDir, const QString& workTree);
+            void setWatchWorkTree(bool enable);
+            bool watchWorkTree() const      { return m_bWorkTree;   }
+            void setDebounce(int ms)        { m_debounce.setInterval(ms); }
+            int debounce() const            { return m_debounce.interval(); }
+            void start();
+            void stop();
+            bool isActive() const           { return m_bActive;     }
+
+        signals:
+            /**
+             * @param changes Combinaison de RepoWatcher::Change
+             *
+             * Ce signal est émit après le délai de regroupement lorsqu'au moins une
+             * modification a été détectée.
+             */
+            void changed(int changes);
+
+        private slots:
+            void on_directoryChanged(const QString& path);
+            void on_fileChanged(const QString& path);
+            void on_debounce_timeout();
+
+        private:
+            void watchFile(const QString& path);
+            void watchTree(const QString& dir, bool skipGitDir);
+            void watchWorkTreeDirs(const QString& dir);
+            void forget(const QString& dir);
+            void checkGitFiles();
+            void notify(int changes);
+
+        private:
+            QFileSystemWatcher* m_watcher;/**< Surveillance système */
+            QTimer m_debounce;/**< Délai de regroupement des notifications */
+            QElapsedTimer m_firstChange;/**< Date de la première notification non émise */
+            int m_pending;/**< Modifications en attente d'émission */
+            bool m_bActive;/**< Surveillance active */
+            bool m_bWorkTree;/**< Surveillance de la copie de travail */
+            int m_generation;/**< Numéro de la surveillance en cours, pour ignorer les résultats Git d'une surveillance arrêtée */
+            QSet<QString> m_watched;/**< Dossiers surveillés */
+            QSet<QString> m_treeDirs;/**< Dossiers de la copie de travail surveillés */
+            QSet<QString> m_ignored;/**< Dossiers de la copie de travail ignorés par Git */
+            QString m_gitDir;/**< Dossier Git du dépôt */
+            QString m_commonDir;/**< Dossier Git commun (refs, packed-refs) */
+            QString m_workTree;/**< Racine de la copie de travail */
+            QHash<QString, QDateTime> m_stamps;/**< Dernière date de modification des fichiers Git surveillés */
+    };
+
+#endif // REPOWATCHER_HPP
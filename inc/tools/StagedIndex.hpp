@@ -0,0 +1,83 @@
+#ifndef STAGEDINDEX_HPP
+#define STAGEDINDEX_HPP
+
+    #include <QByteArray>
+    #include <QString>
+    #include <QVector>
+
+    #include "IndexReader.hpp"
+    #include "StatusParser.hpp"
+
+    /**
+     * @struct StagedChange
+     * @brief Modification indexée calculée par StagedIndex.
+     *
+     * Header : StagedIndex.hpp
+     */
+    struct StagedChange
+    {
+        QString path;/**< Chemin du fichier */
+        char state;/**< Etat côté index, codé comme @b git @b status (@c A, @c M, @c D ou @c T) */
+    };
+
+    /**
+     * @class StagedIndex
+     * @brief La classe StagedIndex calcule la liste des fichiers indexés sans
+     * lancer de processus.
+     *
+     * Une référence (l'état de HEAD pour chaque chemin) est construite à partir
+     * d'un @b git @b status et de l'index lu au même moment : un chemin absent du
+     * status a le même contenu dans HEAD et dans l'index, les autres portent
+     * l'objet de HEAD dans les champs @c mH et @c hH. Tant que HEAD ne change pas,
+     * comparer un nouvel index à cette référence donne directement les fichiers
+     * indexés.@n
+     * Les renommages apparaissent comme un ajout et une suppression jusqu'au
+     * prochain @b git @b status. Les conflits et les formats d'index non
+     * supportés invalident la référence : l'appelant repasse alors par Git.@n
+     * Header : StagedIndex.hpp
+     */
+    class StagedIndex
+    {
+        public:
+            StagedIndex();
+            void setRepository(const QString& gitDir, const QString& commonDir);
+            QString indexPath() const                   { return m_gitDir + "/index"; }
+            QByteArray readHead() const;
+            bool open(IndexReader& index);
+            bool isSupported() const                    { return m_bSupported;  }
+            bool isValid() const                        { return !m_checksum.isEmpty(); }
+            void clear();
+            bool rebuild(const IndexReader& index, const StatusParser& status, const QByteArray& head);
+            bool diff(const IndexReader& index, QVector<StagedChange>& changes) const;
+            const QByteArray& checksum() const          { return m_checksum;    }
+            const QByteArray& head() const              { return m_head;        }
+            int count() const                           { return m_entries.length(); }
+
+        private:
+            /**
+             * @struct HeadEntry
+             * @brief Etat d'un chemin dans HEAD.
+             */
+            struct HeadEntry
+            {
+                int path;/**< Position du chemin dans StagedIndex::m_paths */
+                int pathLength;/**< Longueur du chemin */
+                quint32 mode;/**< Mode du fichier */
+                uchar oid[INDEX_OID_SIZE];/**< Objet du fichier */
+            };
+
+            void append(const char* path, int length, quint32 mode, const uchar* oid);
+            int compare(const HeadEntry& head, const char* path, int length) const;
+
+        private:
+            QString m_gitDir;/**< Dossier Git du dépôt */
+            QString m_commonDir;/**< Dossier Git commun */
+            QString m_objectFormat;/**< Format des identifiants d'objet du dépôt */
+            bool m_bSupported;/**< Format d'index supporté */
+            QByteArray m_checksum;/**< Somme de contrôle de l'index de référence (vide si invalide) */
+            QByteArray m_head;/**< Commit HEAD de référence */
+            QVector<HeadEntry> m_entries;/**< Etat de HEAD, trié par chemin */
+            QByteArray m_paths;/**< Chemins de StagedIndex::m_entries */
+    };
+
+#endif // STAGEDINDEX_HPP
@@ -0,0 +1,65 @@
+#ifndef STATUSCACHE_HPP
+#define STATUSCACHE_HPP
+
+    #include <QString>
+    #include <QStringList>
+    #include <QVector>
+    #include "StatusModel.hpp"
+    #include "RefSnapshot.hpp"
+
+    #define CACHE_DIR       "GitIHM.cache"  /**< Dossier des fichiers de cache (un par dépôt) */
+    #define CACHE_MAGIC     "GSTC"          /**< En-tête d'un fichier de cache */
+    #define CACHE_VERSION   1               /**< Version du format des fichiers de cache */
+
+    /**
+     * @struct CachedStatus
+     * @brief Dernier état connu d'un dépôt, tel qu'affiché par la fenêtre principale.
+     *
+     * Header : StatusCache.hpp
+     */
+    struct CachedStatus
+    {
+        bool statusValid = false;/**< Les listes de fichiers correspondent à l'index et à HEAD actuels */
+        QVector<StatusItem> staged;/**< Fichiers indexés */
+        QVector<StatusItem> unstaged;/**< Fichiers non indexés */
+        QStringList unmerged;/**< Fichiers en conflit */
+        bool refsValid = false;/**< Les références correspondent à HEAD et aux refs actuels */
+        RefSnapshot refs;/**< Branches, tags et dépôts distants */
+        bool stash = false;/**< Le dépôt contient au moins un stash */
+    };
+
+    /**
+     * @class StatusCache
+     * @brief La classe StatusCache enregistre sur disque le dernier état connu d'un dépôt.
+     *
+     * Un fichier par dépôt, nommé d'après le chemin du dépôt, est écrit dans
+     * le dossier CACHE_DIR. Chaque partie (status, références) est
+     * accompagnée de l'empreinte des fichiers Git (voir RepoFingerprint)
+     * relevée à la réception des données : au chargement, une partie dont
+     * l'empreinte ne correspond plus au dépôt est ignorée.@n
+     * Le cache permet d'afficher immédiatement un état, marqué comme ancien,
+     * en attendant le résultat des commandes Git.@n
+     * Header : StatusCache.hpp
+     */
+    class StatusCache
+    {
+        public:
+            StatusCache();
+            void setRepository(const QString& path, const QString& gitDir, const QString& commonDir);
+            void clear();
+            bool isValid() const            { return !m_path.isEmpty(); }
+            void statusUpdated(const QString& path);
+            void refsUpdated();
+            bool save(const CachedStatus& status) const;
+            static bool load(const QString& path, CachedStatus& status);
+            static QString fileName(const QString& path);
+
+        private:
+            QString m_path;/**< Dossier du dépôt (clé du cache) */
+            QString m_gitDir;/**< Dossier Git du dépôt */
+            QString m_commonDir;/**< Dossier Git commun */
+            quint64 m_statusStamp;/**< Empreinte de l'index et de HEAD à la réception du status (0 : aucun) */
+            quint64 m_refsStamp;/**< Empreinte des références à leur réception (0 : aucune) */
+    };
+
+#endif // STATUSCACHE_HPP
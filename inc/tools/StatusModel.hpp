@@ -0,0 +1,68 @@
+#ifndef STATUSMODEL_HPP
+#define STATUSMODEL_HPP
+
+    #include <QAbstractListModel>
+    #include <QHash>
+    #include <QVector>
+    #include <QStringList>
+
+    /**
+     * @struct StatusItem
+     * @brief Ligne d'une liste de fichiers (staged ou unstaged).
+     *
+     * Header : StatusModel.hpp
+     */
+    struct StatusItem
+    {
+        QString path;/**< Chemin du fichier, clé de la ligne */
+        QString text;/**< Texte affiché */
+    };
+
+    /**
+     * @class StatusModel
+     * @brief La classe StatusModel contient une liste de fichiers du status Git.
+     *
+     * Les lignes sont triées par chemin. A chaque mise à jour, seules les
+     * insertions, suppressions et modifications nécessaires sont notifiées à la
+     * vue : la sélection est donc conservée par fichier. Si les changements sont
+     * trop dispersés, la liste est reconstruite en une passe et les index
+     * persistants (dont la sélection) sont déplacés par chemin.@n
+     * Les lignes issues du cache (voir StatusCache) sont marquées anciennes
+     * avec StatusModel::setStale et affichées en gris italique jusqu'à la
+     * prochaine mise à jour.@n
+     * Header : StatusModel.hpp
+     */
+    class StatusModel : public QAbstractListModel
+    {
+        Q_OBJECT
+
+        public:
+            /**
+             * @enum Roles
+             * @brief Rôles spécifiques du modèle.
+             */
+            enum Roles {
+                PathRole = Qt::UserRole/**< Chemin du fichier */
+            };
+
+        public:
+            StatusModel(QObject* parent = nullptr);
+            int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+            QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+            void update(QVector<StatusItem> items);
+            void clear();
+            void setStale(bool stale);
+            bool isStale() const                    { return m_bStale;              }
+            const QVector<StatusItem>& items() const { return m_items;              }
+            QString path(int row) const             { return m_items.at(row).path;  }
+            QStringList paths(const QModelIndexList& indexes) const;
+
+        private:
+            void rebuild(const QVector<StatusItem>& items);
+
+        private:
+            QVector<StatusItem> m_items;/**< Lignes triées par chemin */
+            bool m_bStale;/**< Les lignes proviennent du cache et attendent le résultat de Git */
+    };
+
+#endif // STATUSMODEL_HPP
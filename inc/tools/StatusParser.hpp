@@ -0,0 +1,100 @@
+#ifndef STATUSPARSER_HPP
+#define STATUSPARSER_HPP
+
+    #include <QByteArray>
+    #include <QString>
+    #include <QVector>
+
+    /**
+     * @struct StatusEntry
+     * @brief Entrée de la commande @b git @b status @b --porcelain=v2 @b -z.
+     *
+     * Une entrée ne contient aucune chaîne : les chemins sont repérés par leur
+     * position dans la sortie brute conservée par StatusParser.@n
+     * Header : StatusParser.hpp
+     */
+    struct StatusEntry
+    {
+        /**
+         * @enum Kind
+         * @brief Type de ligne porcelain v2.
+         */
+        enum Kind : quint8 {
+            Ordinary,/**< Ligne @c 1 : fichier suivi modifié */
+            Renamed,/**< Ligne @c 2 : fichier renommé ou copié */
+            Unmerged,/**< Ligne @c u : fichier en conflit */
+            Untracked,/**< Ligne @c ? : fichier non suivi */
+            Ignored/**< Ligne @c ! : fichier ignoré */
+        };
+
+        /**
+         * @enum SubmoduleFlag
+         * @brief Etat d'un sous-module (champ @c sub).
+         */
+        enum SubmoduleFlag : quint8 {
+            NotSubmodule = 0x0,/**< L'entrée n'est pas un sous-module */
+            Submodule = 0x1,/**< L'entrée est un sous-module */
+            CommitChanged = 0x2,/**< Le commit du sous-module a changé */
+            TrackedChanges = 0x4,/**< Le sous-module contient des modifications suivies */
+            UntrackedChanges = 0x8/**< Le sous-module contient des fichiers non suivis */
+        };
+
+        Kind kind;/**< Type de ligne */
+        char x;/**< Etat côté index (@c '.' si non modifié) */
+        char y;/**< Etat côté copie de travail (@c '.' si non modifié) */
+        quint8 submodule;/**< Combinaison de StatusEntry::SubmoduleFlag */
+        int fields;/**< Position du premier champ après XY (-1 si aucun) */
+        int path;/**< Position du chemin */
+        int pathLength;/**< Longueur du chemin */
+        int orig;/**< Position du chemin d'origine d'un renommage (-1 si aucun) */
+        int origLength;/**< Longueur du chemin d'origine */
+
+        bool isStaged() const   { return (kind == Ordinary || kind == Renamed) && x != '.'; }
+        bool isUnstaged() const { return kind == Untracked || ((kind == Ordinary || kind == Renamed) && y != '.'); }
+    };
+
+    /**
+     * @class StatusParser
+     * @brief La classe StatusParser analyse la sortie de @b git @b status
+     * @b --porcelain=v2 @b -z.
+     *
+     * L'analyse travaille directement sur la sortie brute de la commande, sans
+     * conversion en QString ni découpage en lignes. Les chemins ne sont décodés
+     * qu'à la demande grâce aux fonctions StatusParser::path et
+     * StatusParser::origPath.@n
+     * Header : StatusParser.hpp
+     */
+    class StatusParser
+    {
+        public:
+            StatusParser();
+            bool parse(const QByteArray& raw);
+            void clear();
+            const QVector<StatusEntry>& entries() const     { return m_entries;     }
+            const QByteArray& raw() const                   { return m_raw;         }
+            QString path(const StatusEntry& entry) const;
+            QString origPath(const StatusEntry& entry) const;
+            QByteArray rawPath(const StatusEntry& entry) const;
+            QByteArray field(const StatusEntry& entry, int index) const;
+            QString branchHead() const                      { return m_branchHead;  }
+            QByteArray branchOid() const                    { return m_branchOid;   }
+            QString branchUpstream() const                  { return m_upstream;    }
+            int ahead() const                               { return m_ahead;       }
+            int behind() const                              { return m_behind;      }
+
+        private:
+            int skipFields(int pos, int end, int count) const;
+            quint8 submoduleFlags(int pos) const;
+            void parseHeader(int pos, int end);
+
+        private:
+            QByteArray m_raw;/**< Sortie brute de la commande (partagée, non copiée) */
+            QVector<StatusEntry> m_entries;/**< Entrées analysées */
+            QString m_branchHead;/**< Branche courante (en-tête branch.head) */
+            QByteArray m_branchOid;/**< Commit courant (en-tête branch.oid) */
+            QString m_upstream;/**< Branche amont (en-tête branch.upstream) */
+            int m_ahead;/**< Nombre de commits en avance (en-tête branch.ab) */
+            int m_behind;/**< Nombre de commits en retard (en-tête branch.ab) */
+    };
+
+#endif // STATUSPARSER_HPP
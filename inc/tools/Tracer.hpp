@@ -0,0 +1,106 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+    #include <QByteArray>
+    #include <QElapsedTimer>
+    #include <QHash>
+    #include <QMutex>
+    #include <QString>
+    #include <QVector>
+
+    #define TRACE_MAX_EVENTS    65536   /**< Nombre d'événements conservés pour l'export (les plus récents) */
+    #define TRACE_BUCKETS       32      /**< Nombre de classes des histogrammes (puissances de 2 en microsecondes) */
+
+    /**
+     * @struct TraceEvent
+     * @brief Durée d'une phase enregistrée par le Tracer.
+     *
+     * Header : Tracer.hpp
+     */
+    struct TraceEvent
+    {
+        const char* name = nullptr;/**< Nom de la phase (chaîne statique) */
+        qint64 start = 0;/**< Début (ns depuis le démarrage du Tracer) */
+        qint64 duration = 0;/**< Durée (ns) */
+        quint64 thread = 0;/**< Thread d'exécution */
+        QString detail;/**< Précision facultative (commande Git, ...) */
+    };
+
+    /**
+     * @struct TracePhase
+     * @brief Histogramme des durées d'une phase.
+     *
+     * La classe @c i compte les durées comprises entre 2^(i-1) et 2^i
+     * microsecondes.@n
+     * Header : Tracer.hpp
+     */
+    struct TracePhase
+    {
+        quint64 count = 0;/**< Nombre de mesures */
+        qint64 total = 0;/**< Durée cumulée (ns) */
+        qint64 max = 0;/**< Durée maximale (ns) */
+        quint32 buckets[TRACE_BUCKETS] = {};/**< Histogramme */
+
+        qint64 percentile(double p) const;
+    };
+
+    /**
+     * @class Tracer
+     * @brief La classe Tracer mesure la durée des phases de l'application.
+     *
+     * Chaque mesure alimente l'histogramme de sa phase et est conservée dans un
+     * tampon circulaire des #TRACE_MAX_EVENTS derniers événements. Le tout peut
+     * être exporté au format JSON "trace event" de Chrome (chrome://tracing,
+     * Perfetto) avec Tracer::exportChromeTrace.@n
+     * Les noms de phase doivent être des chaînes statiques : seul leur pointeur
+     * est conservé dans les événements.@n
+     * Header : Tracer.hpp
+     */
+    class Tracer
+    {
+        private:
+            Tracer();
+
+        public:
+            static Tracer* Instance();
+            qint64 now() const                          { return m_clock.nsecsElapsed(); }
+            void record(const char* name, qint64 start, qint64 end, const QString& detail = QString());
+            QHash<QByteArray, TracePhase> phases() const;
+            void clear();
+            bool exportChromeTrace(const QString& fileName) const;
+
+        private:
+            QElapsedTimer m_clock;/**< Origine des dates */
+            mutable QMutex m_mutex;/**< Protège les événements et les histogrammes */
+            QVector<TraceEvent> m_events;/**< Tampon circulaire des événements */
+            int m_next;/**< Prochaine case du tampon */
+            QHash<QByteArray, TracePhase> m_phases;/**< Histogramme de chaque phase */
+    };
+
+    #define qTrace Tracer::Instance()
+
+    /**
+     * @class TraceSpan
+     * @brief Mesure la durée de vie d'une portée.
+     *
+     * La phase est enregistrée dans le Tracer à la destruction de l'objet :
+     * @code
+     * TraceSpan span("status/parse");
+     * @endcode
+     * Header : Tracer.hpp
+     */
+    class TraceSpan
+    {
+        public:
+            explicit TraceSpan(const char* name, const QString& detail = QString()) :
+                m_name(name), m_detail(detail), m_start(qTrace->now()) {}
+            ~TraceSpan()                                { qTrace->record(m_name, m_start, qTrace->now(), m_detail); }
+
+        private:
+            Q_DISABLE_COPY(TraceSpan)
+            const char* m_name;/**< Nom de la phase */
+            QString m_detail;/**< Précision facultative */
+            qint64 m_start;/**< Début de la mesure */
+    };
+
+#endif // TRACER_HPP
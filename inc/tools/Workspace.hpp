@@ -0,0 +1,89 @@
+#ifndef WORKSPACE_HPP
+#define WORKSPACE_HPP
+
+    #include <QDateTime>
+    #include <QObject>
+    #include <QStringList>
+    #include <QTimer>
+    #include <QVector>
+
+    class StatusParser;
+
+    #define WORKSPACE_REFRESH_S 30  /**< Période de rafraîchissement des dépôts en arrière-plan (s) */
+
+    /**
+     * @struct RepoSummary
+     * @brief Résumé de l'état d'un dépôt de l'espace de travail.
+     *
+     * Header : Workspace.hpp
+     */
+    struct RepoSummary
+    {
+        QString path;/**< Dossier du dépôt */
+        QString branch;/**< Branche courante (vide si HEAD détachée) */
+        int staged = 0;/**< Nombre de fichiers indexés */
+        int unstaged = 0;/**< Nombre de fichiers modifiés non indexés */
+        int untracked = 0;/**< Nombre de fichiers non suivis */
+        int conflicts = 0;/**< Nombre de fichiers en conflit */
+        int ahead = 0;/**< Nombre de commits en avance sur la branche amont */
+        int behind = 0;/**< Nombre de commits en retard sur la branche amont */
+        bool hasUpstream = false;/**< La branche a une branche amont */
+        bool valid = false;/**< Le dernier status a réussi */
+        bool pending = false;/**< Un status est en cours */
+        QString error;/**< Erreur du dernier status */
+        QDateTime updated;/**< Date du dernier status */
+    };
+
+    /**
+     * @class Workspace
+     * @brief La classe Workspace suit l'état de plusieurs dépôts.
+     *
+     * Chaque dépôt est résumé à partir d'un @b git @b status @b --porcelain=v2
+     * @b --branch lancé en basse priorité (voir GitExecutor::background) : les
+     * commandes du dépôt affiché par la fenêtre principale passent toujours en
+     * premier et le nombre de processus reste borné par GitExecutor.@n
+     * Le dépôt au premier plan n'est pas interrogé : son résumé est mis à jour
+     * par le status de la fenêtre principale (Workspace::setSummary).@n
+     * Header : Workspace.hpp
+     */
+    class Workspace : public QObject
+    {
+        Q_OBJECT
+
+        public:
+            Workspace(QObject* parent = nullptr);
+            static QString normalize(const QString& path);
+            void setRepositories(const QStringList& paths);
+            QStringList repositories() const;
+            bool add(const QString& path);
+            void remove(const QString& path);
+            int indexOf(const QString& path) const;
+            const QVector<RepoSummary>& summaries() const   { return m_repos;       }
+            void setForeground(const QString& path);
+            QString foreground() const                      { return m_foreground;  }
+            void setSummary(const QString& path, const StatusParser& parser, int untracked = -1);
+            void refreshAll();
+
+        signals:
+            /**
+             * Ce signal est émit à chaque ajout ou retrait de dépôt.
+             */
+            void changed();
+            /**
+             * @param index Position du dépôt
+             *
+             * Ce signal est émit à chaque mise à jour du résumé d'un dépôt.
+             */
+            void updated(int index);
+
+        private:
+            void refresh(int index);
+            static void summarize(RepoSummary& summary, const StatusParser& parser);
+
+        private:
+            QVector<RepoSummary> m_repos;/**< Dépôts suivis */
+            QString m_foreground;/**< Dépôt affiché par la fenêtre principale */
+            QTimer m_timer;/**< Rafraîchissement périodique */
+    };
+
+#endif // WORKSPACE_HPP
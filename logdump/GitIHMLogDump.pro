@@ -0,0 +1,18 @@
+QT       += core
+QT       -= gui
+
+TARGET = GitIHMLogDump
+TEMPLATE = app
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DESTDIR = ./../../build
+
+SOURCES += \
+        main.cpp
+
+HEADERS += \
+        ../inc/tools/Logger.hpp
+
+INCLUDEPATH += ../inc/tools
@@ -0,0 +1,157 @@
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include "Logger.hpp"
+
+/**
+ * @struct DumpFilter
+ * @brief Critères de sélection des messages affichés.
+ */
+struct DumpFilter
+{
+    int level = Logger::Debug;/**< Niveau minimal */
+    qint64 since = 0;/**< Date minimale (ms depuis l'epoch) */
+    QString pattern;/**< Texte recherché (vide : tous les messages) */
+};
+
+/**
+ * @param level Niveau du message
+ * @return Préfixe du niveau, identique à celui du journal texte
+ */
+static QString levelString(int level)
+{
+    switch(level)
+    {
+        case Logger::Debug:     return "DBG | ";
+        case Logger::Info:      return "INF | ";
+        case Logger::Warning:   return "WRN | ";
+        case Logger::Error:     return "ERR | ";
+        case Logger::Fatal:     return "FTL | ";
+    }
+    return "??? | ";
+}
+
+/**
+ * @param fileName Journal binaire
+ * @param filter Critères de sélection
+ * @param out Sortie texte
+ * @return @c false si le fichier n'est pas un journal binaire lisible
+ *
+ * Relit un journal binaire et écrit les messages sélectionnés au format du
+ * journal texte. Le texte des messages écartés par leur niveau ou leur date
+ * n'est pas décodé.
+ */
+static bool dump(const QString& fileName, const DumpFilter& filter, QTextStream& out)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        QTextStream(stderr) << fileName << " : " << file.errorString() << endl;
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    char magic[4];
+    quint8 version = 0;
+    if(stream.readRawData(magic, 4) != 4 || QByteArray(magic, 4) != LOG_BINARY_MAGIC)
+    {
+        QTextStream(stderr) << fileName << " : pas un journal binaire" << endl;
+        return false;
+    }
+    stream >> version;
+    if(version != LOG_BINARY_VERSION)
+    {
+        QTextStream(stderr) << fileName << " : version " << version << " non supportée" << endl;
+        return false;
+    }
+
+    while(!stream.atEnd())
+    {
+        qint64 time;
+        quint8 level;
+        quint16 keywordsSize;
+        quint32 textSize;
+        stream >> time >> level >> keywordsSize >> textSize;
+        if(stream.status() != QDataStream::Ok)
+            break;
+
+        if(level < filter.level || time < filter.since)
+        {
+            if(stream.skipRawData(keywordsSize + textSize) != int(keywordsSize + textSize))
+                break;
+            continue;
+        }
+
+        QByteArray keywords(keywordsSize, Qt::Uninitialized);
+        QByteArray text(int(textSize), Qt::Uninitialized);
+        if(stream.readRawData(keywords.data(), keywords.size()) != keywords.size() ||
+           stream.readRawData(text.data(), text.size()) != text.size())
+            break;
+        QString message = QString::fromUtf8(text);
+        if(!filter.pattern.isEmpty() && !message.contains(filter.pattern, Qt::CaseInsensitive))
+            continue;
+
+        QString datetimeStr = QDateTime::fromMSecsSinceEpoch(time).toString("yyyy-MM-dd HH:mm:ss.zzz | ");
+        QString errStr = levelString(level);
+        QString keywordsStr = QString::fromUtf8(keywords);
+        for(const QString& str : message.split('\n'))
+        {
+            if(str.trimmed() != "")
+            {
+                out << datetimeStr << errStr << keywordsStr << str.trimmed() << '\n';
+                errStr = "    | ";
+            }
+        }
+    }
+    if(!stream.atEnd() || stream.status() != QDataStream::Ok)
+    {
+        // Fichier tronqué : écriture interrompue
+        QTextStream(stderr) << fileName << " : dernier message incomplet" << endl;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QStringList args = a.arguments();
+    args.removeFirst();
+    DumpFilter filter;
+    QStringList files;
+    for(int i = 0; i < args.length(); i++)
+    {
+        const QString& arg = args.at(i);
+        bool bValue = i + 1 < args.length();
+        if(arg == "--level" && bValue)
+            filter.level = args.at(++i).toInt();
+        else if(arg == "--since" && bValue)
+            filter.since = QDateTime::fromString(args.at(++i), Qt::ISODate).toMSecsSinceEpoch();
+        else if(arg == "--grep" && bValue)
+            filter.pattern = args.at(++i);
+        else
+            files << arg;
+    }
+    if(files.isEmpty())
+    {
+        QTextStream(stderr) << "Usage : GitIHMLogDump [--level 0-4] [--since yyyy-MM-ddTHH:mm:ss] [--grep texte] journal..." << endl;
+        return 2;
+    }
+
+    QFile stdoutFile;
+    stdoutFile.open(stdout, QIODevice::WriteOnly);
+    QTextStream out(&stdoutFile);
+    out.setCodec("UTF-8");
+    bool bOk = true;
+    for(const QString& fileName : files)
+    {
+        bOk = dump(fileName, filter, out) && bOk;
+    }
+    out.flush();
+    return bOk ? 0 : 1;
+}
@@ -1,6 +1,7 @@
 #include "BranchWindow.hpp"
 #include "ui_BranchWindow.h"
 
+#include <QHash>
 #include <QMessageBox>
 
 #include "Logger.hpp"
@@ -32,37 +33,23 @@ BranchWindow::~BranchWindow()
 }
 
 /**
- * @param branches Nouvelle liste des branches
+ * @param refs Nouvelles références du dépôt
  *
- * Met à jour la liste des branches en la remplaçant par la liste
- * @c branches fournies en argument de cette fonction. Si l'élément
+ * Met à jour la liste des branches en la remplaçant par les branches
+ * locales de @c refs fournies en argument de cette fonction. Si l'élément
  * qui était précédemment sélectionné est modifié/supprimé, le
- * premier élément de la liste devient l'élément sélectionné.
+ * premier élément de la liste devient l'élément sélectionné.@n
+ * La branche amont de chaque branche et son avance/retard (voir
+ * RefService::setTracking) sont affichés dans l'info-bulle de l'élément.
  */
-void BranchWindow::update_branches(QStringList branches)
+void BranchWindow::update_branches(const RefSnapshot& refs)
 {
     qLog->info("BranchWindow - Mise à jour des branches");
     ui->lineEdit_add->clear();
 
     QString branch;
     QString selected = get_selected();
-    for(int i = 0; i < branches.length(); i++)
-    {
-        branch = branches[i];
-        if(branch.simplified() == "")
-        {
-            branches.removeAt(i);
-            i--;
-        }
-        else if(branch[0] == QChar('*'))
-        {
-            branches[i] = branch.split(' ').at(1).simplified();
-        }
-        else
-        {
-            branches[i] = branch.simplified();
-        }
-    }
+    QStringList branches = refs.branches();
 
     // Ajout/Suppression
     for(int i = 0; i < ui->listWidget_branch->count(); i++)
@@ -84,6 +71,31 @@ void BranchWindow::update_branches(QStringList branches)
         ui->listWidget_branch->sortItems();
     }
 
+    // Branches amont
+    QHash<QString, const RefRecord*> records;
+    for(const RefRecord& record : refs.records())
+    {
+        if(record.type == RefRecord::Branch)
+            records.insert(record.name, &record);
+    }
+    for(int i = 0; i < ui->listWidget_branch->count(); i++)
+    {
+        QListWidgetItem* item = ui->listWidget_branch->item(i);
+        const RefRecord* record = records.value(item->text(), nullptr);
+        if(!record || record->upstream.isEmpty())
+        {
+            item->setToolTip("Aucune branche amont");
+            continue;
+        }
+        RefRecord upstream;
+        RefSnapshot::setRefname(upstream, record->upstream);
+        if(record->gone)
+            item->setToolTip("Branche amont " + upstream.name + " supprimée");
+        else
+            item->setToolTip("Branche amont " + upstream.name + " : " + QString::number(record->ahead) + " commit(s) en avance, "
+                             + QString::number(record->behind) + " en retard");
+    }
+
     // Gestion sélection
     for(int i = 0; i < ui->listWidget_branch->count(); i++)
     {
@@ -94,6 +106,8 @@ void BranchWindow::update_branches(QStringList branches)
             return;
         }
     }
+    if(ui->listWidget_branch->count() == 0)
+        return;
     ui->listWidget_branch->item(0)->setSelected(true);
     on_listWidget_branch_currentItemChanged(ui->listWidget_branch->item(0), nullptr);
 }
@@ -0,0 +1,112 @@
+#include "FetchWindow.hpp"
+#include "ui_FetchWindow.h"
+
+#include <QHeaderView>
+#include <QProgressBar>
+
+/**
+ * @param parent Le QWidget parent de cette fenêtre
+ * @param remotes Dépôts distants, un par ligne
+ *
+ * Contructeur de la classe FetchWindow.@n
+ * Cette fenêtre se détruit à sa fermeture, les commandes continuant sans elle.
+ */
+FetchWindow::FetchWindow(QWidget *parent, const QStringList& remotes) :
+    QMainWindow(parent),
+    ui(new Ui::FetchWindow),
+    m_pending(0),
+    m_failed(0)
+{
+    ui->setupUi(this);
+
+    setAttribute(Qt::WA_DeleteOnClose);
+    setAttribute(Qt::WA_QuitOnClose, false);
+    ui->tableWidget_remotes->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    ui->tableWidget_remotes->setRowCount(remotes.length());
+    for(int row = 0; row < remotes.length(); row++)
+    {
+        ui->tableWidget_remotes->setItem(row, 0, new QTableWidgetItem(remotes.at(row)));
+        QProgressBar* bar = new QProgressBar();
+        bar->setRange(0, 0);
+        bar->setFormat("En attente");
+        ui->tableWidget_remotes->setCellWidget(row, 1, bar);
+        ui->tableWidget_remotes->setItem(row, 2, new QTableWidgetItem());
+    }
+}
+
+/**
+ * Destructeur de la classe FetchWindow.
+ */
+FetchWindow::~FetchWindow()
+{
+    delete ui;
+}
+
+/**
+ * @param row Ligne du dépôt distant
+ * @param job Commande de fetch du dépôt distant
+ *
+ * Affiche la progression puis le résultat de la commande sur la ligne.
+ */
+void FetchWindow::track(int row, GitJob* job)
+{
+    QProgressBar* bar = qobject_cast<QProgressBar*>(ui->tableWidget_remotes->cellWidget(row, 1));
+    m_pending++;
+    updateSummary();
+    if(job->isRunning())
+        bar->setFormat("Connexion");
+
+    connect(job, &GitJob::started, bar, [bar]() {
+        bar->setFormat("Connexion");
+    });
+    connect(job, &GitJob::progress, bar, [bar](const QString& phase, int percent) {
+        bar->setRange(0, 100);
+        bar->setValue(percent);
+        bar->setFormat(phase + " : %p%");
+    });
+    connect(job, &GitJob::finished, this, [this, row, bar](const GitResult& result) {
+        bar->setRange(0, 100);
+        bar->setValue(100);
+        QString text;
+        if(result.success())
+        {
+            bar->setFormat("Terminé en " + QString::number(result.elapsed) + " ms");
+            text = "OK";
+        }
+        else
+        {
+            m_failed++;
+            bar->setFormat(result.canceled ? "Annulé" : "Echec");
+            QStringList lines = result.errorText().trimmed().split('\n');
+            text = lines.last().trimmed();
+        }
+        ui->tableWidget_remotes->item(row, 2)->setText(text);
+        ui->tableWidget_remotes->item(row, 2)->setToolTip(result.errorText());
+        m_pending--;
+        updateSummary();
+    });
+    connect(this, &FetchWindow::cancel, job, &GitJob::cancel);
+}
+
+/**
+ * Ce connecteur est activé par un clic souris de l'utilisateur sur le
+ * bouton Annuler.@n
+ * Annule les commandes qui ne sont pas terminées.
+ */
+void FetchWindow::on_pushButton_cancel_clicked()
+{
+    emit cancel();
+}
+
+/**
+ * Affiche le nombre de commandes en cours et en échec.
+ */
+void FetchWindow::updateSummary()
+{
+    int total = ui->tableWidget_remotes->rowCount();
+    if(m_pending > 0)
+        ui->label_summary->setText(QString::number(m_pending) + " fetch en cours sur " + QString::number(total));
+    else
+        ui->label_summary->setText("Terminé : " + QString::number(total - m_failed) + " réussis, " + QString::number(m_failed) + " en échec");
+    ui->pushButton_cancel->setEnabled(m_pending > 0);
+}
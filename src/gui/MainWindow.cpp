@@ -7,26 +7,84 @@
 #include <QTimer>
 #include <QFileDialog>
 #include <QShortcut>
+#include <QAction>
+#include <QEvent>
+#include <QWindow>
+#include <QSet>
 #include "ErrorViewer.hpp"
+#include "FetchWindow.hpp"
+#include "OutputViewer.hpp"
 #include "TagsWindow.hpp"
 #include "BranchWindow.hpp"
+#include "PerfDock.hpp"
+#include "WorkspaceDock.hpp"
 #include "Context.hpp"
 #include "Logger.hpp"
+#include "StatusParser.hpp"
+#include "Tracer.hpp"
+
+#define TICK_LOG_PERIOD 60 /**< Nombre de ticks du timer entre deux bilans dans le log */
 
 /**
  * @param parent Le QWidget parent de cette fenêtre
  *
- * Contructeur de la classe MainWindow.@n
- * Initialise son attribut MainWindow::m_process.
+ * Contructeur de la classe MainWindow.
  */
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::MainWindow)
+    ui(new Ui::MainWindow),
+    m_bInGitDir(false),
+    m_bFirstPaint(false),
+    m_bStatusPending(false),
+    m_bStatusAgain(false),
+    m_bUntrackedPending(false),
+    m_bUntrackedAgain(false),
+    m_refreshPending(0),
+    m_refreshTraceStart(0),
+    m_bRefreshAll(false),
+    m_fetchPending(0),
+    m_statusCost(0),
+    m_ticksRun(0),
+    m_ticksSkipped(0)
 {
     ui->setupUi(this);
     qLog->info("Ouverture fenêtre principale");
 
-    m_process = new QProcess();
+    m_stagedModel = new StatusModel(this);
+    m_unstagedModel = new StatusModel(this);
+    ui->listView_staged->setModel(m_stagedModel);
+    ui->listView_unstaged->setModel(m_unstagedModel);
+
+    m_refs = new RefService(this);
+    connect(m_refs, &RefService::updated, this, &MainWindow::refs_updated);
+
+    m_refresh = new RefreshCoalescer(this);
+    connect(m_refresh, &RefreshCoalescer::flush, this, &MainWindow::refresh_flush);
+
+    m_workspace = new Workspace(this);
+    m_workspace->setRepositories(qCtx->workspace());
+
+    m_watcher = new RepoWatcher(this);
+    m_watcher->setWatchWorkTree(qCtx->watchWorkTree());
+    connect(m_watcher, &RepoWatcher::changed, this, &MainWindow::repository_changed);
+
+    qGit->setMaxParallel(qCtx->processPool());
+    qGit->setTimeout(GitExecutor::Query, qCtx->timeoutQuery());
+    qGit->setTimeout(GitExecutor::Local, qCtx->timeoutLocal());
+    qGit->setTimeout(GitExecutor::Network, qCtx->timeoutNetwork());
+
+    // Progression et annulation de la commande en cours
+    m_progress = new QProgressBar(this);
+    m_progress->setMaximumWidth(320);
+    m_progress->setTextVisible(true);
+    m_cancel = new QToolButton(this);
+    m_cancel->setText("Annuler");
+    m_cancel->setToolTip("Annuler la commande en cours");
+    ui->statusBar->addPermanentWidget(m_progress);
+    ui->statusBar->addPermanentWidget(m_cancel);
+    connect(m_cancel, &QToolButton::clicked, this, &MainWindow::cancel_command);
+    hideProgress();
+
     ui->lineEdit_commit->setPlaceholderText(GIT_COMMIT_PLACEHOLDER);
 
     // Git dir
@@ -35,7 +93,37 @@ MainWindow::MainWindow(QWidget *parent) :
     init();
     QShortcut* shortcutRefress = new QShortcut(QKeySequence(Qt::CTRL+Qt::Key_F5), this);
     connect(shortcutRefress, &QShortcut::activated, this, &MainWindow::update_all);
-    connect(&m_timer, &QTimer::timeout, this, &MainWindow::update_status);
+    connect(&m_timer, &QTimer::timeout, this, &MainWindow::timer_tick);
+    connect(&m_untrackedTimer, &QTimer::timeout, this, [this]() {
+        m_refresh->request(RefreshCoalescer::Untracked);
+    });
+
+    // Panneau des performances, masqué par défaut
+    PerfDock* perfDock = new PerfDock(this);
+    addDockWidget(Qt::BottomDockWidgetArea, perfDock);
+    perfDock->hide();
+
+    // Espace de travail, affiché s'il contient des dépôts
+    WorkspaceDock* workspaceDock = new WorkspaceDock(m_workspace, this);
+    addDockWidget(Qt::RightDockWidgetArea, workspaceDock);
+    workspaceDock->setVisible(!m_workspace->summaries().isEmpty());
+    connect(workspaceDock, &WorkspaceDock::open, this, [this](const QString& path) {
+        if(path != qCtx->currentGitDir())
+            setGitDir(path);
+    });
+
+    // Menu contextuel de la fenêtre
+    QAction* actionPerf = perfDock->toggleViewAction();
+    actionPerf->setShortcut(QKeySequence(Qt::CTRL+Qt::SHIFT+Qt::Key_P));
+    addAction(actionPerf);
+    QAction* actionWorkspace = workspaceDock->toggleViewAction();
+    actionWorkspace->setShortcut(QKeySequence(Qt::CTRL+Qt::SHIFT+Qt::Key_W));
+    addAction(actionWorkspace);
+    QAction* actionTrace = new QAction("Exporter la trace des performances...", this);
+    actionTrace->setShortcut(QKeySequence(Qt::CTRL+Qt::SHIFT+Qt::Key_T));
+    connect(actionTrace, &QAction::triggered, this, &MainWindow::export_trace);
+    addAction(actionTrace);
+    setContextMenuPolicy(Qt::ActionsContextMenu);
 }
 
 /**
@@ -44,6 +132,7 @@ MainWindow::MainWindow(QWidget *parent) :
 MainWindow::~MainWindow()
 {
     qLog->info("Fermeture fenêtre principale");
+    saveCache();
     clear();
     delete ui;
 }
@@ -52,37 +141,37 @@ MainWindow::~MainWindow()
  * Fonction d'initialisation de la fenêtre.@n
  * Récupère les informations du projet avec les méthodes GET de la classe
  * Context pour charger les informations nécessaires au bon fonctionnement
- * de cet onglet. Puis démarre le timer MainWindow::m_timer.@n
+ * de cet onglet. Puis arme le timer MainWindow::m_timer.@n
+ * En démarrage différé (voir Context::deferredStartup), seul le cache du
+ * dépôt est affiché : la vérification du dépôt et les commandes Git sont
+ * lancées après le premier affichage (voir MainWindow::first_paint).@n
  * Voir @ref CONTEXT_GET.
  */
 void MainWindow::init()
 {
     // AutoRefresh
     ui->spinBox_timerTime->setVisible(false);
-    m_timer.setInterval(qCtx->timerTime() * 1000);
+    m_timer.setSingleShot(true);
     ui->checkBox_autoRefresh->setChecked(qCtx->timer());
+    ui->checkBox_watch->setChecked(qCtx->watch());
 
-    setGitDir(qCtx->currentGitDir());
-    this->update_all();
-    ui->comboBox_branch->setCurrentIndex(ui->comboBox_branch->findText(ui->label_branch->text().split(':').at(1).simplified()));
-    ui->comboBox_remote->setCurrentIndex(0);
+    setGitDir(qCtx->currentGitDir(), !qCtx->deferredStartup());
 }
 
 /**
  * Fonction de nettoyage de l'onglet Git.@n
- * Vide toute les liste de cet onglet et tue le processus en cours
- * s'il y en a un.
+ * Vide toute les liste de cet onglet et tue les commandes Git en cours
+ * s'il y en a.
  */
 void MainWindow::clear()
 {
-    ui->listWidget_staged->clear();
-    ui->listWidget_unstaged->clear();
+    m_stagedModel->clear();
+    m_unstagedModel->clear();
     ui->checkBox_amend->setChecked(false);
     ui->lineEdit_commit->clear();
     ui->comboBox_branch->clear();
     ui->comboBox_remote->clear();
-    m_process->kill();
-    delete m_process;
+    qGit->clear();
 }
 
 /**
@@ -102,12 +191,11 @@ void MainWindow::on_pushButton_commit_clicked()
     QString msg = ui->lineEdit_commit->text().simplified();
     if(msg == QString("")) msg = GIT_COMMIT_DEFAULT_MSG;
     args << msg;
-    if(action(args))
-    {
+    action(args, [this](const GitResult&) {
         ui->lineEdit_commit->clear();
         ui->checkBox_amend->setChecked(false);
-        update_status();
-    }
+        m_refresh->request(RefreshCoalescer::Status | RefreshCoalescer::Refs);
+    });
 }
 
 /**
@@ -123,9 +211,10 @@ void MainWindow::on_checkBox_amend_stateChanged(int arg1)
 {
     if(arg1 == Qt::Checked)
     {
-        while(!action(QStringList() << "log" << "-n1" << "--pretty=format:%s", false))
-        {}
-        ui->lineEdit_commit->setText(m_output);
+        query(QStringList() << "log" << "-n1" << "--pretty=format:%s", [this](const GitResult& result) {
+            if(ui->checkBox_amend->isChecked())
+                ui->lineEdit_commit->setText(result.outputText());
+        });
     }
     else
     {
@@ -136,19 +225,29 @@ void MainWindow::on_checkBox_amend_stateChanged(int arg1)
 /**
  * Ce connecteur est activé suite à un clic souris de l'utilisateur sur
  * le bouton outil "..." à droite de la sélection des branches.@n
- * Ouvre la fenêtre de gestion des branches.@n
+ * Ouvre la fenêtre de gestion des branches. Tant qu'elle est ouverte,
+ * l'avance/retard de chaque branche sur sa branche amont est calculé à chaque
+ * mise à jour des références (voir RefService::setTracking).@n
  * Voir BranchesWindow.
  */
 void MainWindow::on_toolButton_branch_clicked()
 {
-    if(action(QStringList() << "branch"))
+    if(!m_bInGitDir)
     {
-        BranchWindow* w = new BranchWindow(this);
-        connect(w, &BranchWindow::action, this, &MainWindow::action_branch);
-        connect(this, &MainWindow::branch_update, w, &BranchWindow::update_branches);
-        w->show();
-        w->update_branches(m_output.split('\n'));
+        QMessageBox::critical(this, "Erreur", "Veuillez sélectionner un dossier Git valide");
+        return;
     }
+    BranchWindow* w = new BranchWindow(this);
+    w->setAttribute(Qt::WA_DeleteOnClose);
+    connect(w, &BranchWindow::action, this, &MainWindow::action_branch);
+    connect(this, &MainWindow::refs_update, w, &BranchWindow::update_branches);
+    connect(w, &QObject::destroyed, this, [this]() {
+        m_refs->setTracking(false);
+    });
+    w->show();
+    w->update_branches(m_refs->snapshot());
+    m_refs->setTracking(true);
+    m_refresh->request(RefreshCoalescer::Refs);
 }
 
 /**
@@ -162,14 +261,10 @@ void MainWindow::on_toolButton_branch_clicked()
 void MainWindow::on_pushButton_add_clicked()
 {
     qLog->info("Demande de Add");
-    QStringList selection = getSelected(ui->listWidget_unstaged);
-    bool bOk = false;
-    if(selection.length() == 0) bOk = action(QStringList() << "add" << ".");
-    else bOk = action(QStringList() << "add" << selection);
-    if(bOk)
-    {
-        update_status();
-    }
+    QStringList selection = getSelected(ui->listView_unstaged);
+    GitCallback onSuccess = [this](const GitResult&) { m_refresh->request(RefreshCoalescer::Status | RefreshCoalescer::Untracked); };
+    if(selection.length() == 0) action(QStringList() << "add" << ".", onSuccess);
+    else action(QStringList() << "add" << selection, onSuccess);
 }
 
 /**
@@ -183,14 +278,10 @@ void MainWindow::on_pushButton_add_clicked()
 void MainWindow::on_pushButton_reset_clicked()
 {
     qLog->info("Demande de Reset");
-    QStringList selection = getSelected(ui->listWidget_staged);
-    bool bOk = false;
-    if(selection.length() == 0) bOk = action(QStringList() << "reset" << "HEAD");
-    else bOk = action(QStringList() << "reset" << selection);
-    if(bOk)
-    {
-        update_status();
-    }
+    QStringList selection = getSelected(ui->listView_staged);
+    GitCallback onSuccess = [this](const GitResult&) { m_refresh->request(RefreshCoalescer::Status | RefreshCoalescer::Untracked); };
+    if(selection.length() == 0) action(QStringList() << "reset" << "HEAD", onSuccess);
+    else action(QStringList() << "reset" << selection, onSuccess);
 }
 
 /**
@@ -204,8 +295,8 @@ void MainWindow::on_pushButton_reset_clicked()
 void MainWindow::on_pushButton_checkout_clicked()
 {
     qLog->info("Demande de Checkout");
-    QStringList selection = getSelected(ui->listWidget_staged);
-    selection << getSelected(ui->listWidget_unstaged);
+    QStringList selection = getSelected(ui->listView_staged);
+    selection << getSelected(ui->listView_unstaged);
     selection.removeDuplicates();
     if(selection.length() > 0)
     {
@@ -215,9 +306,11 @@ void MainWindow::on_pushButton_checkout_clicked()
                                     "Êtes-vous sûr de vouloir annuler les modifications "
                                     "apportées à ces fichiers ?\n" +
                                     selection.join('\n'));
-        if(rep == QMessageBox::Yes && action(QStringList() << "checkout" << "--" << selection))
+        if(rep == QMessageBox::Yes)
         {
-            update_status();
+            action(QStringList() << "checkout" << "--" << selection, [this](const GitResult&) {
+                m_refresh->request(RefreshCoalescer::Status);
+            });
         }
     }
 }
@@ -248,11 +341,15 @@ void MainWindow::on_pushButton_gitk_clicked()
  */
 void MainWindow::on_pushButton_tags_clicked()
 {
-    while(!action(QStringList() << "tag", false)){}
-    TagsWindow* w = new TagsWindow(this, m_output.split('\n'));
+    if(!m_bInGitDir)
+    {
+        QMessageBox::critical(this, "Erreur", "Veuillez sélectionner un dossier Git valide");
+        return;
+    }
+    TagsWindow* w = new TagsWindow(this, m_refs->snapshot());
     connect(w, &TagsWindow::action, this, &MainWindow::action_tags);
     connect(this, &MainWindow::tag_created, w, &TagsWindow::clean_tag_name);
-    connect(this, &MainWindow::tag_update, w, &TagsWindow::update_tags);
+    connect(this, &MainWindow::refs_update, w, &TagsWindow::update_tags);
     w->show();
 }
 
@@ -266,7 +363,7 @@ void MainWindow::on_pushButton_tags_clicked()
  */
 void MainWindow::on_pushButton_push_clicked()
 {
-    action(QStringList() << "push" << ui->comboBox_remote->currentText() << ui->comboBox_branch->currentText());
+    action(QStringList() << "push" << "--progress" << ui->comboBox_remote->currentText() << ui->comboBox_branch->currentText());
 }
 
 /**
@@ -278,7 +375,64 @@ void MainWindow::on_pushButton_push_clicked()
  */
 void MainWindow::on_pushButton_fetch_clicked()
 {
-    action(QStringList() << "fetch" << ui->comboBox_remote->currentText());
+    action(QStringList() << "fetch" << "--progress" << ui->comboBox_remote->currentText());
+}
+
+/**
+ * Ce connecteur est activé par un clic souris de l'utilisateur sur le
+ * bouton Fetch tous.@n
+ * Exécute la commande @b git @b fetch pour chaque dépôt distant. Les commandes
+ * sont exécutées en parallèle (voir GitExecutor::Concurrent) dans la limite de
+ * GitExecutor::maxParallel processus, et leur avancement est affiché dans une
+ * fenêtre FetchWindow. Les références ne sont mises à jour qu'une fois, à la
+ * fin de toutes les commandes.@n
+ * Les commandes parallèles partagent le même dépôt : elles n'écrivent pas
+ * @c FETCH_HEAD (option @c --no-write-fetch-head, ou @c --append avant Git
+ * 2.29), qui ne contiendrait que le résultat de la dernière, et ne lancent
+ * pas chacune leur @b git @b gc ni leur mise à jour du commit-graph (options
+ * @c --no-auto-gc et @c --no-write-commit-graph, depuis Git 2.24). Un seul
+ * @b git @b gc @b --auto est exécuté après la dernière commande.
+ */
+void MainWindow::on_pushButton_fetchAll_clicked()
+{
+    QStringList remotes = m_refs->snapshot().remotes();
+    if(!m_bInGitDir || remotes.isEmpty())
+    {
+        status("Aucun dépôt distant");
+        return;
+    }
+    if(m_fetchPending > 0)
+    {
+        status("Fetch des dépôts distants déjà en cours");
+        return;
+    }
+
+    qLog->info("Fetch de", remotes.length(), "dépôts distants");
+    QStringList options;
+    options << "fetch" << "--progress";
+    // Avant Git 2.29, FETCH_HEAD ne peut qu'être complété, pas ignoré
+    options << (qGit->versionAtLeast(2, 29) ? "--no-write-fetch-head" : "--append");
+    if(qGit->versionAtLeast(2, 24))
+        options << "--no-auto-gc" << "--no-write-commit-graph";
+    FetchWindow* w = new FetchWindow(this, remotes);
+    for(int row = 0; row < remotes.length(); row++)
+    {
+        GitJob* job = action(QStringList() << options << remotes.at(row), nullptr, false, GitExecutor::Concurrent);
+        if(!job)
+            continue;
+        w->track(row, job);
+        m_fetchPending++;
+        connect(job, &GitJob::finished, this, [this](const GitResult& result) {
+            if(--m_fetchPending == 0)
+            {
+                status("Fetch des dépôts distants terminé");
+                m_refresh->request(RefreshCoalescer::Refs);
+                // Dans le dépôt des fetch, même si le dossier courant a changé
+                qGit->execute(result.workingDirectory, QStringList() << "gc" << "--auto" << "--quiet");
+            }
+        });
+    }
+    w->show();
 }
 
 /**
@@ -297,265 +451,507 @@ void MainWindow::on_pushButton_rebase_clicked()
  * bouton Exécuter.@n
  * Exécute la commande @b git @b &lt;cmd> grâce à la fonction MainWindow::action.
  * La commande à exécuter est celle renseignée dans la ligne d'édition à la
- * gauche de ce bouton.
+ * gauche de ce bouton. Sa sortie est affichée au fil de l'exécution dans une
+ * fenêtre OutputViewer.
  */
 void MainWindow::on_pushButton_extra_clicked()
 {
     qLog->info("Action custom utilisateur");
-    if(action(ui->lineEdit_extra->text().split(' ')))
-    {
+    QStringList args = ui->lineEdit_extra->text().split(' ', QString::SkipEmptyParts);
+    GitJob* job = action(args, [this](const GitResult&) {
         ui->lineEdit_extra->clear();
         update_all();
+    }, true, GitExecutor::Write, true);
+    if(job)
+    {
+        OutputViewer* w = new OutputViewer(this, "git " + args.join(' '));
+        connect(job, &GitJob::outputReady, w, &OutputViewer::append);
+        connect(job, &GitJob::finished, w, &OutputViewer::finish);
     }
 }
 
 /**
  * @param args Les argument pour la commande @b git
+ * @param onSuccess Traitement à exécuter si la commande réussit
  * @param b_status Indicateur d'affichage du status de l'action
- * @return Si l'attribut MainWindow::m_process est déjà en cours d'utilisation,
- * renvoie @c false, sinon, renvoie true après exécution de la fonction.
+ * @param mode Type d'accès au dépôt de la commande
+ * @param b_stream La sortie est transmise au fil de l'exécution (voir
+ * GitExecutor::stream)
+ * @return Job associé à la commande, ou @c nullptr si la commande n'a pas pu
+ * être mise en file d'attente.
  *
- * Passe le curseur en mode attente. Exécute la commande @b git avec pour
- * arguments ceux passés en paramètres. Attend la fin de l'exécution de la
- * commande pour récupérer le code retour, la sortie et l'erreur.
+ * Place la commande @b git avec pour arguments ceux passés en paramètres dans
+ * la file d'attente de GitExecutor. Cette fonction n'attend pas la fin de la
+ * commande : le code retour, la sortie et l'erreur sont transmis au traitement
+ * @c onSuccess lorsque la commande se termine avec succès.@n
+ * Si @c b_status est vrai, la commande et sa progression sont affichées dans
+ * la barre de status, avec un bouton d'annulation.@n
+ * Si le dossier courant a changé pendant la commande (voir
+ * MainWindow::setGitDir), le traitement @c onSuccess n'est pas exécuté : le
+ * résultat concerne un autre dépôt que celui affiché.
  */
-bool MainWindow::action(QStringList args, bool b_status /*= true*/)
+GitJob* MainWindow::action(QStringList args, GitCallback onSuccess /*= nullptr*/, bool b_status /*= true*/,
+                           GitExecutor::Mode mode /*= GitExecutor::Write*/, bool b_stream /*= false*/)
 {
     if(!m_bInGitDir)
     {
         QMessageBox::critical(this, "Erreur", "Veuillez sélectionner un dossier Git valide");
         qLog->error("Action demandée sur dossier Git non valide");
+        return nullptr;
+    }
+    if(args.length() == 0)
+    {
+        return nullptr;
     }
-    else if(m_process->state() == QProcess::NotRunning && args.length() > 0)
-    {
-        if(b_status)
-            status("Lancement git " + args.at(0));
-        if(!(ui->checkBox_autoRefresh->isChecked() && args.length() && args.at(0) == "status"))
-            qLog->info("GIT | git", args.join(' '));
-        m_process->start("git", args);
-        m_process->waitForFinished();
-        m_error = m_process->readAllStandardError();
-        m_output = m_process->readAllStandardOutput();
-        m_last_exit_code = m_process->exitCode();
-        if(m_process->exitStatus() != QProcess::NormalExit) m_last_exit_code = -1;
-        if(b_status) status("Fin d'exécution (code retour : " + QString::number(m_last_exit_code) + ")");
-        if(m_last_exit_code > 0)
+
+    if(!(ui->checkBox_autoRefresh->isChecked() && args.at(0) == "status"))
+        qLog->info("GIT | git", args.join(' '));
+    const QString dir = qCtx->currentGitDir();
+    GitJob* job = b_stream ? qGit->stream(dir, args, mode)
+                           : qGit->execute(dir, args, mode);
+    if(b_status)
+        showProgress(job);
+    connect(job, &GitJob::finished, this, [this, job, dir, b_status, onSuccess](const GitResult& result) {
+        TraceSpan span("action/callback", result.args.join(' '));
+        if(m_statusJob == job)
+            hideProgress();
+        if(result.canceled)
+        {
+            if(b_status)
+                status("Commande git " + result.args.at(0) + " annulée");
+        }
+        else if(!result.success())
         {
             if(b_status)
             {
                 ErrorViewer *w = new ErrorViewer(this,
                                                  "Erreur d'exécution de la commande git",
-                                                 m_error);
+                                                 result.errorText());
                 w->show();
             }
-            return false;
         }
-        return true;
-    }
-    return false;
+        else if(dir != qCtx->currentGitDir())
+        {
+            qLog->info("Résultat ignoré, le dossier a changé : git", result.args.join(' '));
+        }
+        else if(onSuccess)
+        {
+            onSuccess(result);
+        }
+    });
+    return job;
 }
 
-bool MainWindow::checkForGitDir()
+/**
+ * @param args Les argument pour la commande @b git
+ * @param onSuccess Traitement à exécuter si la commande réussit
+ * @return Job associé à la commande, ou @c nullptr si la commande n'a pas pu
+ * être mise en file d'attente.
+ *
+ * Exécute une commande @b git en lecture seule, sans affichage dans le status.
+ * Ces commandes peuvent être exécutées en parallèle par GitExecutor.
+ */
+GitJob* MainWindow::query(QStringList args, GitCallback onSuccess)
 {
-    bool lastInGit = m_bInGitDir;
-    m_bInGitDir = true; // Passage à true pour éviter erreur
-    bool bOk = action(QStringList() << "status", false);
-    if(!bOk)
+    return action(args, onSuccess, false, GitExecutor::ReadOnly);
+}
+
+/**
+ * Vérifie que le dossier courant est lié à un dépôt Git grâce à la classe
+ * RepoLocator, qui renvoie aussi les dossiers à surveiller sans lancer de
+ * processus. En cas de succès, démarre le timer de rafraîchissement et la
+ * surveillance si besoin et met à jour l'affichage. Un dépôt nu, sans copie
+ * de travail, est refusé.
+ */
+void MainWindow::checkForGitDir()
+{
+    m_bInGitDir = false;
+    m_timer.stop();
+    m_untrackedTimer.stop();
+    m_watcher->stop();
+    m_cache.clear();
+    RepoLocation location;
+    bool bFound;
+    {
+        TraceSpan span("repo/locate");
+        bFound = m_locator.locate(qCtx->currentGitDir(), location);
+    }
+    if(!bFound || location.isBare())
     {
-        qLog->warning("Le dossier", qCtx->currentGitDir(), "n'est pas lié à un repo Git");
+        qLog->warning("Le dossier", qCtx->currentGitDir(), bFound ? "est un dépôt nu" : "n'est pas lié à un repo Git");
         QMessageBox::critical(this,
                               "Erreur",
-                              "Ce dossier n'est pas lié à un repo Git !");
+                              bFound ? "Ce dossier est un dépôt nu, sans copie de travail !"
+                                     : "Ce dossier n'est pas lié à un repo Git !");
+        return;
     }
-    m_bInGitDir = lastInGit; //Reset de la valeur
-    return bOk;
+    m_bInGitDir = true;
+    m_watcher->setRepository(location.gitDir, location.commonDir, location.workTree);
+    m_fingerprint.setRepository(location.gitDir, location.commonDir);
+    m_stagedIndex.setRepository(location.gitDir, location.commonDir);
+    m_refs->setRepository(qCtx->currentGitDir(), location.gitDir, location.commonDir);
+    m_cache.setRepository(qCtx->currentGitDir(), location.gitDir, location.commonDir);
+    m_fingerprint.update();
+    m_lastAutoRefresh.start();
+    scheduleTick();
+    if(qCtx->watch())
+    {
+        m_watcher->start();
+    }
+    update_all();
 }
 
 /**
  * @brief MainWindow::updateStash met à jour la visibilité du bouton POP
+ * @return Job de la commande lancée, ou @c nullptr si aucune commande n'a été lancée
  */
-void MainWindow::updateStash()
+GitJob* MainWindow::updateStash()
 {
-    // Get state
-    bool hasStash = false;
-    if(action(QStringList() << "stash" << "-list"))
-    {
-        if(m_output.trimmed() != "")
-        {
-            hasStash = true;
-        }
-    }
-
-    // Maj buttons
-    ui->pushButton_pop->setEnabled(hasStash);
-
-    // Update status
-    update_status();
+    return query(QStringList() << "stash" << "list", [this](const GitResult& result) {
+        // Maj buttons
+        ui->pushButton_pop->setEnabled(result.outputText().trimmed() != "");
+    });
 }
 
 /**
  * Mise à jour du status.@n
  * Cette fonction utilise la commande @b git @b status pour récuppérer l'état courant
- * du dépôt git et actualise les listes de fichiers de cet onglet.
+ * du dépôt git et actualise les listes de fichiers de cet onglet. Les fichiers
+ * non suivis sont ignorés (option @c -uno) : ils sont recherchés séparément
+ * par MainWindow::update_untracked, à moindre fréquence.@n
+ * Si l'index a changé depuis le dernier status, la liste des fichiers indexés
+ * est d'abord actualisée par lecture directe de l'index (voir
+ * MainWindow::updateStagedFromIndex), puis corrigée par le résultat de Git.@n
+ * Si une mise à jour est déjà en cours, une nouvelle mise à jour sera lancée
+ * à la fin de celle-ci.
+ * @return Job de la commande lancée, ou @c nullptr si aucune commande n'a été lancée
  */
-void MainWindow::update_status()
+GitJob* MainWindow::update_status()
 {
+    if(m_bStatusPending)
+    {
+        m_bStatusAgain = true;
+        return nullptr;
+    }
     if(!ui->checkBox_autoRefresh->isChecked())
         qLog->info("Mise à jour du status");
-    QStringList tmp_select_stage = getSelected(ui->listWidget_staged, false);
-    QStringList tmp_select_unstage = getSelected(ui->listWidget_unstaged, false);
-    QStringList tmp_stage = getAllItems(ui->listWidget_staged, false);
-    QStringList tmp_unstage = getAllItems(ui->listWidget_unstaged, false);
 
-    if(action(QStringList() << "status" << "-s", false))
-    {
-        QStringList state_list = m_output.split('\n');
-        state_list.sort();
+    QByteArray head = m_stagedIndex.readHead();
+    QByteArray checksum = updateStagedFromIndex(head);
+    GitJob* job = query(QStringList() << "status" << "--porcelain=v2" << "--branch" << "-z" << "-uno", [this, head, checksum](const GitResult& result) {
+        StatusParser parser;
+        {
+            TraceSpan span("status/parse");
+            parser.parse(result.output);
+        }
+        m_workspace->setSummary(result.workingDirectory, parser, m_untracked.length());
+        TraceSpan spanWidgets("status/widgets");
         m_unmerged.clear();
 
-        // Ajout des nouveaux items
-        for(QString state : state_list)
+        QVector<StatusItem> staged;
+        QVector<StatusItem> unstaged;
+        QSet<QString> tracked;
+        for(const StatusEntry& entry : parser.entries())
         {
-            if(state.length() > 3)
+            StatusItem item;
+            item.path = parser.path(entry);
+            tracked.insert(item.path);
+            if(entry.kind == StatusEntry::Unmerged)
             {
-                QString file_name = state.right(state.length()-3);
-                if(state.at(0) == QChar('U') ||
-                   state.at(1) == QChar('U'))
-                {
-                    m_unmerged.append(file_name);
-                }
-                else
-                {
-                    QString label0 = stateChar2Label(state.at(0), true);
-                    QString label1 = stateChar2Label(state.at(1));
-                    if(label0 != "")
-                    {
-                        QString text = label0 + " : " + file_name;
-                        if(!tmp_stage.contains(text))
-                        {
-                            ui->listWidget_staged->addItem(text);
-                            if(tmp_select_stage.contains(text))
-                            {
-                                ui->listWidget_staged->item(ui->listWidget_staged->count()-1)->setSelected(true);
-                            }
-                        }
-                        else
-                        {
-                            tmp_stage.removeOne(text);
-                        }
-                    }
-                    if(label1 != "")
-                    {
-                        QString text = label1 + " : " + file_name;
-                        if(!tmp_unstage.contains(text))
-                        {
-                            ui->listWidget_unstaged->addItem(label1 + " : " + file_name);
-                            if(tmp_select_unstage.contains(text))
-                            {
-                                ui->listWidget_unstaged->item(ui->listWidget_unstaged->count()-1)->setSelected(true);
-                            }
-                        }
-                        else
-                        {
-                            tmp_unstage.removeOne(text);
-                        }
-                    }
-                }
+                m_unmerged.append(item.path);
+                continue;
+            }
+            QString display_name = item.path;
+            if(entry.kind == StatusEntry::Renamed)
+            {
+                display_name = parser.origPath(entry) + " -> " + item.path;
             }
-        }
 
-        // Suppression des items qui n'existent plus
-        for(int i = 0; i < tmp_stage.length(); i++)
-        {
-            for(int j = 0; j < ui->listWidget_staged->count(); j++)
+            QString label0 = stateChar2Label(QChar(entry.x), true);
+            QString label1 = stateChar2Label(QChar(entry.y));
+            if(label0 != "")
             {
-                if(tmp_stage[i] == ui->listWidget_staged->item(j)->text())
-                {
-                    ui->listWidget_staged->takeItem(j);
-                }
+                item.text = label0 + " : " + display_name;
+                staged.append(item);
             }
-        }
-        for(int i = 0; i < tmp_unstage.length(); i++)
-        {
-            for(int j = 0; j < ui->listWidget_unstaged->count(); j++)
+            if(label1 != "")
             {
-                if(tmp_unstage[i] == ui->listWidget_unstaged->item(j)->text())
-                {
-                    ui->listWidget_unstaged->takeItem(j);
-                }
+                item.text = label1 + " : " + display_name;
+                unstaged.append(item);
             }
         }
 
-        // Tri
-        ui->listWidget_staged->sortItems();
-        ui->listWidget_unstaged->sortItems();
+        // Les fichiers ajoutés depuis la dernière recherche ne sont plus non suivis
+        for(int i = m_untracked.length() - 1; i >= 0; i--)
+        {
+            if(tracked.contains(m_untracked.at(i).path))
+                m_untracked.remove(i);
+        }
+
+        // Mise à jour différentielle des listes
+        m_stagedModel->update(staged);
+        m_unstagedTracked = unstaged;
+        updateUnstaged();
+        updateCommitButton();
+        m_cache.statusUpdated(result.workingDirectory);
 
-        // Activation bouton commit
-        if(ui->listWidget_staged->count() == 0 && !ui->checkBox_amend->isChecked()) ui->pushButton_commit->setEnabled(false);
-        else ui->pushButton_commit->setEnabled(true);
+        // Référence des fichiers indexés, si l'index et HEAD n'ont pas changé pendant le status
+        TraceSpan spanBaseline("status/baseline");
+        bool bUpToDate = m_stagedIndex.isValid() && m_stagedIndex.checksum() == checksum && m_stagedIndex.head() == head;
+        if(!bUpToDate)
+        {
+            IndexReader index;
+            if(!checksum.isEmpty() && m_stagedIndex.open(index) &&
+               index.checksum() == checksum && m_stagedIndex.readHead() == head)
+            {
+                m_stagedIndex.rebuild(index, parser, head);
+            }
+            else
+            {
+                m_stagedIndex.clear();
+            }
+        }
+    });
+    if(job)
+    {
+        m_bStatusPending = true;
+        connect(job, &GitJob::finished, this, [this](const GitResult& result) {
+            m_bStatusPending = false;
+            // Durée lissée (moyenne mobile exponentielle), hors commandes annulées
+            if(!result.canceled)
+                m_statusCost = m_statusCost == 0 ? result.elapsed : (3 * m_statusCost + result.elapsed) / 4;
+            if(m_bStatusAgain)
+            {
+                m_bStatusAgain = false;
+                update_status();
+            }
+            else
+            {
+                scheduleTick();
+            }
+        });
     }
+    return job;
 }
 
 /**
- * Mise à jour des branches.@n
- * Cette fonction utilise la commande @b git @b branch pour récuppérer la liste
- * des branche du dépôt git et actualise la liste des branches de cet onglet.
+ * @param head Commit HEAD courant (voir StagedIndex::readHead)
+ * @return Somme de contrôle de l'index lu, vide si l'index n'a pas pu être lu
+ *
+ * Lit l'index du dépôt sans lancer de processus. Si l'index a changé depuis
+ * le dernier status et que HEAD est inchangée, la liste des fichiers indexés
+ * est recalculée immédiatement par comparaison avec la référence construite
+ * lors du dernier status (voir StagedIndex).@n
+ * Si le format de l'index n'est pas supporté, un avertissement est enregistré
+ * et seul @b git @b status est utilisé.
  */
-void MainWindow::update_branches()
+QByteArray MainWindow::updateStagedFromIndex(const QByteArray& head)
 {
-    qLog->info("Mise à jour des branches");
-    if(action(QStringList() << "branch", false))
+    TraceSpan span("status/index");
+    IndexReader index;
+    bool bSupported = m_stagedIndex.isSupported();
+    bool bOpen = m_stagedIndex.open(index);
+    if(!bOpen)
+    {
+        if(bSupported && !m_stagedIndex.isSupported())
+            qLog->warning(index.errorString(), ": les fichiers indexés seront calculés par Git");
+        return QByteArray();
+    }
+
+    QByteArray checksum = index.checksum();
+    if(m_stagedIndex.isValid() && checksum != m_stagedIndex.checksum() && head == m_stagedIndex.head())
     {
-        QStringList branch_list = m_output.split('\n');
-        QString current_text = ui->comboBox_branch->currentText();
-        ui->comboBox_branch->clear();
-        for(QString branch : branch_list)
+        QElapsedTimer clock;
+        clock.start();
+        QVector<StagedChange> changes;
+        if(m_stagedIndex.diff(index, changes))
         {
-            branch = branch.simplified();
-            if(branch.length() > 0)
+            QVector<StatusItem> staged;
+            staged.reserve(changes.length());
+            for(const StagedChange& change : changes)
             {
-                if(branch[0] == QChar('*'))
+                QString label = stateChar2Label(QChar(change.state), true);
+                if(label != "")
                 {
-                    branch = branch.right(branch.length()-2);
-                    ui->label_branch->setText("Branche courante : " + branch);
+                    StatusItem item;
+                    item.path = change.path;
+                    item.text = label + " : " + change.path;
+                    staged.append(item);
                 }
-                ui->comboBox_branch->addItem(branch);
             }
+            m_stagedModel->update(staged);
+            updateCommitButton();
+            qLog->info("Fichiers indexés lus dans l'index :", index.entries().length(), "entrées,",
+                       changes.length(), "modifications en", clock.elapsed(), "ms");
         }
-        ui->comboBox_branch->setCurrentIndex(ui->comboBox_branch->findText(current_text));
     }
-    on_comboBox_branch_currentIndexChanged(ui->comboBox_branch->currentText());
+    return checksum;
+}
+
+/**
+ * Active le bouton commit s'il y a des fichiers indexés ou si le dernier
+ * commit doit être modifié.
+ */
+void MainWindow::updateCommitButton()
+{
+    if(m_stagedModel->rowCount() == 0 && !ui->checkBox_amend->isChecked()) ui->pushButton_commit->setEnabled(false);
+    else ui->pushButton_commit->setEnabled(true);
 }
 
 /**
- * Mise à jour des dépôts distants.@n
- * Cette fonction utilise la commande @b git @b remote pour récuppérer la liste
- * des dépôts distants et actualise la liste des dépôts distants de cet onglet.
+ * Recherche des fichiers non suivis.@n
+ * Le status rapide (MainWindow::update_status) ignore les fichiers non suivis
+ * (option @c -uno) : ils sont recherchés par un @b git @b status complet en
+ * basse priorité (voir GitExecutor::background), toutes les
+ * Context::untrackedTime secondes et après les actions qui peuvent les
+ * modifier.@n
+ * Context::untrackedCache et Context::fsmonitor activent (@c true),
+ * désactivent (@c false) ou laissent à la configuration du dépôt (@c auto) le
+ * cache des fichiers non suivis et fsmonitor pour cette recherche.@n
+ * Par défaut, la recherche ne prend aucun verrou (voir GitExecutor::background)
+ * et ne peut donc pas gêner une commande lancée par l'utilisateur hors de
+ * l'application ; le cache n'est alors pas enregistré dans l'index et n'est
+ * rafraîchi que par les commandes Git qui écrivent l'index. Ce n'est que si le
+ * cache est explicitement activé (@c untracked-cache=true) que Git peut
+ * prendre le verrou optionnel de l'index pour y enregistrer le cache à jour.@n
+ * Seuls les fichiers non suivis du résultat sont utilisés : la liste des
+ * fichiers non indexés est recomposée par MainWindow::updateUnstaged.
+ * @return Job de la commande lancée, ou @c nullptr si aucune commande n'a été lancée
  */
-void MainWindow::update_remote()
+GitJob* MainWindow::update_untracked()
 {
-    qLog->info("Mise à jour des repo distants");
-    if(action(QStringList() << "remote", false))
+    if(m_bUntrackedPending)
+    {
+        m_bUntrackedAgain = true;
+        return nullptr;
+    }
+    if(!m_bInGitDir)
     {
-        QStringList remote_list = m_output.split('\n');
-        QString current_text = ui->comboBox_remote->currentText();
-        ui->comboBox_remote->clear();
-        for(QString remote : remote_list)
+        return nullptr;
+    }
+
+    QStringList args;
+    if(qCtx->untrackedCache() != Context::Auto)
+        args << "-c" << QString("core.untrackedCache=") + (qCtx->untrackedCache() == Context::On ? "true" : "false");
+    if(qCtx->fsmonitor() != Context::Auto)
+        args << "-c" << QString("core.fsmonitor=") + (qCtx->fsmonitor() == Context::On ? "true" : "false");
+    args << "status" << "--porcelain=v2" << "--branch" << "-z" << "--untracked-files=normal" << "--ignore-submodules=all";
+    const QString dir = qCtx->currentGitDir();
+    GitJob* job = qGit->background(dir, args, qCtx->untrackedCache() == Context::On);
+    m_bUntrackedPending = true;
+    connect(job, &GitJob::finished, this, [this, dir](const GitResult& result) {
+        m_bUntrackedPending = false;
+        // Le dossier a pu changer pendant la recherche
+        if(result.success() && dir == qCtx->currentGitDir())
         {
-            remote = remote.simplified();
-            if(remote.length() > 0)
+            StatusParser parser;
+            {
+                TraceSpan span("untracked/parse");
+                parser.parse(result.output);
+            }
+            m_workspace->setSummary(dir, parser);
+            QVector<StatusItem> untracked;
+            for(const StatusEntry& entry : parser.entries())
             {
-                ui->comboBox_remote->addItem(remote);
+                if(entry.kind != StatusEntry::Untracked)
+                    continue;
+                StatusItem item;
+                item.path = parser.path(entry);
+                item.text = GIT_STATUS_LABEL_1 + " : " + item.path;
+                untracked.append(item);
             }
+            m_untracked = untracked;
+            updateUnstaged();
         }
-        ui->comboBox_remote->setCurrentIndex(ui->comboBox_remote->findText(current_text));
+        if(m_bUntrackedAgain)
+        {
+            m_bUntrackedAgain = false;
+            update_untracked();
+        }
+    });
+    return job;
+}
+
+/**
+ * Met à jour la liste des fichiers non indexés à partir du dernier status
+ * rapide et de la dernière recherche des fichiers non suivis. Un fichier
+ * présent dans les deux n'est affiché qu'une fois, avec son état suivi.
+ */
+void MainWindow::updateUnstaged()
+{
+    QVector<StatusItem> items = m_unstagedTracked;
+    QSet<QString> tracked;
+    for(const StatusItem& item : m_unstagedTracked)
+        tracked.insert(item.path);
+    for(const StatusItem& item : m_untracked)
+    {
+        if(!tracked.contains(item.path))
+            items.append(item);
     }
+    m_unstagedModel->update(items);
+}
+
+/**
+ * Mise à jour des références.@n
+ * Cette fonction utilise le service RefService pour récupérer les branches, tags
+ * et branches distantes du dépôt, lus directement dans les fichiers du dépôt ou
+ * à défaut par une seule commande. Le résultat est appliqué par la fonction
+ * MainWindow::refs_updated.
+ * @return Job de la commande lancée, @c nullptr si aucune commande n'a été lancée
+ */
+GitJob* MainWindow::update_refs()
+{
+    qLog->info("Mise à jour des références");
+    if(!m_bInGitDir)
+    {
+        return nullptr;
+    }
+    TraceSpan span("refs/refresh");
+    return m_refs->refresh();
+}
+
+/**
+ * @param refs Nouvelle liste des références
+ *
+ * Ce connecteur est activé à chaque mise à jour des références.@n
+ * Actualise la liste des branches, la branche courante et la liste des dépôts
+ * distants de cet onglet, puis transmet les références aux fenêtres de gestion
+ * des branches et des tags grâce au signal MainWindow::refs_update.
+ */
+void MainWindow::refs_updated(const RefSnapshot& refs)
+{
+    TraceSpan span("refs/widgets");
+    m_cache.refsUpdated();
+    ui->label_branch->setStyleSheet("");
+    // Branches
+    QString current_text = ui->comboBox_branch->currentText();
+    QString current_branch = refs.currentBranch();
+    ui->comboBox_branch->clear();
+    ui->comboBox_branch->addItems(refs.branches());
+    ui->label_branch->setText("Branche courante : " + (current_branch.isEmpty() ? QString("HEAD détachée") : current_branch));
+    int idx = ui->comboBox_branch->findText(current_text);
+    if(idx == -1) idx = ui->comboBox_branch->findText(current_branch);
+    ui->comboBox_branch->setCurrentIndex(idx);
+    on_comboBox_branch_currentIndexChanged(ui->comboBox_branch->currentText());
+
+    // Dépôts distants
+    current_text = ui->comboBox_remote->currentText();
+    ui->comboBox_remote->clear();
+    ui->comboBox_remote->addItems(refs.remotes());
+    idx = ui->comboBox_remote->findText(current_text);
+    ui->comboBox_remote->setCurrentIndex(idx == -1 ? 0 : idx);
+
+    emit refs_update(refs);
 }
 
 /**
  * Mise à jour générale.@n
- * Appelle les fonctions MainWindow::update_branches, MainWindow::update_status et
- * MainWindow::update_remote pour mettre à jour les listes de cet onglet.
+ * Demande le rafraîchissement de toutes les ressources (voir
+ * RefreshCoalescer). Les requêtes sont lancées au tour de boucle
+ * d'événements suivant par la fonction MainWindow::refresh_flush : elles
+ * sont indépendantes et en lecture seule, donc exécutées en parallèle (voir
+ * GitExecutor::setMaxParallel) et chaque résultat est affiché dès sa
+ * réception.
  */
 void MainWindow::update_all()
 {
@@ -569,10 +965,62 @@ void MainWindow::update_all()
         QMessageBox::critical(this, "Erreur", "Veuillez sélectionner un dossier Git valide");
         return;
     }
-    update_branches();
-    update_status();
-    update_remote();
-    status("Affichage à jour");
+    m_bRefreshAll = true;
+    m_refresh->request(RefreshCoalescer::All);
+}
+
+/**
+ * @param resources Combinaison de RefreshCoalescer::Resource
+ *
+ * Ce connecteur est activé une fois par tour de boucle d'événements pour
+ * toutes les demandes de rafraîchissement regroupées.@n
+ * Lance une seule requête par ressource. Si une mise à jour générale a été
+ * demandée, sa fin est notifiée par le signal MainWindow::refreshed.
+ */
+void MainWindow::refresh_flush(int resources)
+{
+    if(!m_bInGitDir)
+    {
+        m_bRefreshAll = false;
+        return;
+    }
+    QList<GitJob*> jobs;
+    if(resources & RefreshCoalescer::Refs)
+        jobs << update_refs();
+    if(resources & RefreshCoalescer::Status)
+        jobs << update_status();
+    if(resources & RefreshCoalescer::Stash)
+        jobs << updateStash();
+    if(resources & RefreshCoalescer::Untracked)
+        jobs << update_untracked();
+    if(!m_bRefreshAll)
+        return;
+    m_bRefreshAll = false;
+
+    jobs.removeAll(nullptr);
+    if(jobs.isEmpty() && m_refreshPending == 0)
+    {
+        emit refreshed();
+        return;
+    }
+    if(m_refreshPending == 0)
+    {
+        m_refreshClock.start();
+        m_refreshTraceStart = qTrace->now();
+    }
+    m_refreshPending += jobs.length();
+    for(GitJob* job : jobs)
+    {
+        connect(job, &GitJob::finished, this, [this]() {
+            if(--m_refreshPending == 0)
+            {
+                qTrace->record("refresh/all", m_refreshTraceStart, qTrace->now());
+                qLog->info("Mise à jour globale terminée en", m_refreshClock.elapsed(), "ms");
+                status("Affichage à jour");
+                emit refreshed();
+            }
+        });
+    }
 }
 
 /**
@@ -581,7 +1029,7 @@ void MainWindow::update_all()
  * @return Libellé à afficher
  *
  * Cette fonction permet de renvoyer le libellé à afficher en fonction du
- * caractère renvoyé par la fonction @b git @b status @b -s.
+ * caractère d'état XY renvoyé par la fonction @b git @b status @b --porcelain=v2.
  */
 QString MainWindow::stateChar2Label(QChar c, bool staged /*= false*/)
 {
@@ -595,66 +1043,116 @@ QString MainWindow::stateChar2Label(QChar c, bool staged /*= false*/)
     else return "";
 }
 
-bool MainWindow::setGitDir(const QString& dirName)
+/**
+ * @param dirName Dossier à utiliser
+ * @param b_check Lancer la vérification du dossier
+ *
+ * Enregistre le cache du dossier courant puis l'oublie : aucun résultat
+ * reçu avant la vérification du nouveau dossier ne peut l'alimenter.@n
+ * Change le dossier Git courant, affiche son cache puis lance la
+ * vérification de ce dossier grâce à la fonction MainWindow::checkForGitDir.@n
+ * Les requêtes encore en attente ou en cours sur l'ancien dossier sont
+ * annulées (voir GitExecutor::cancelQueries).
+ */
+void MainWindow::setGitDir(const QString& dirName, bool b_check /*= true*/)
 {
+    saveCache();
+    m_cache.clear();
     QDir dir(dirName);
     QString absoluteDir = dir.absolutePath();
+    QString previousDir = qCtx->currentGitDir();
     qCtx->setCurrentGitDir(absoluteDir);
-    m_process->setWorkingDirectory(absoluteDir);
+    m_bStatusAgain = false;
+    m_bUntrackedAgain = false;
+    if(previousDir != absoluteDir)
+        qGit->cancelQueries(previousDir);
     ui->label_gitDir->setText(absoluteDir);
-    m_bInGitDir = checkForGitDir();
-    if(m_bInGitDir && qCtx->timer())
-    {
-        m_timer.start();
-    }
-    else
-    {
-        m_timer.stop();
-    }
-    return m_bInGitDir;
+    m_workspace->setForeground(absoluteDir);
+    m_unstagedTracked.clear();
+    m_untracked.clear();
+    loadCache(absoluteDir);
+    if(b_check)
+        checkForGitDir();
 }
 
 /**
- * @param list_view QListWidget d'où proviennent les items
- * @param only_files Booléen de sélection de la forme de sortie
- * @return Liste des éléments sélectionnés
+ * @param path Dossier du dépôt
  *
- * Renvoie la liste des éléments sélectionnés dans le QListWidget @c list_view
- * sous forme d'une liste de chaînes de caractères. Si @c only_files est passé
- * à @b true, cette liste ne contient pas l'état des fichiers de cette liste.
+ * Affiche immédiatement le dernier état enregistré du dépôt (voir
+ * StatusCache), s'il correspond encore à l'index, à HEAD et aux références.
+ * Les listes et la branche courante sont marquées anciennes jusqu'à
+ * réception du résultat des commandes Git. Sans status valide en cache, les
+ * listes sont vidées.
  */
-QStringList MainWindow::getSelected(QListWidget *list_view, bool only_files /*= true*/)
+void MainWindow::loadCache(const QString& path)
 {
-    QStringList items;
-    for(int i = 0; i < list_view->count(); i++)
+    CachedStatus cached;
+    bool bLoaded = StatusCache::load(path, cached);
+    if(!cached.statusValid)
+    {
+        // Les listes de l'ancien dépôt ne doivent pas rester sélectionnables
+        m_stagedModel->clear();
+        m_unstagedModel->clear();
+        m_unmerged.clear();
+        updateCommitButton();
+    }
+    if(!bLoaded)
+        return;
+    qLog->info("Affichage du cache de", path,
+               cached.statusValid ? "(status" : "(sans status", cached.refsValid ? "et références)" : "sans références)");
+    if(cached.statusValid)
     {
-        if(list_view->item(i)->isSelected())
+        // Les fichiers non suivis sont reconnus à leur libellé (voir MainWindow::update_untracked)
+        for(const StatusItem& item : cached.unstaged)
         {
-            if(only_files) items << list_view->item(i)->text().split(':').at(1).simplified();
-            else items << list_view->item(i)->text();
+            if(item.text.startsWith(GIT_STATUS_LABEL_1 + " : "))
+                m_untracked.append(item);
+            else
+                m_unstagedTracked.append(item);
         }
+        m_stagedModel->update(cached.staged);
+        m_unstagedModel->update(cached.unstaged);
+        m_stagedModel->setStale(true);
+        m_unstagedModel->setStale(true);
+        m_unmerged = cached.unmerged;
+        updateCommitButton();
     }
-    return items;
+    if(cached.refsValid)
+    {
+        refs_updated(cached.refs);
+        ui->label_branch->setStyleSheet("color: gray; font-style: italic;");
+        ui->pushButton_pop->setEnabled(cached.stash);
+    }
+    status("Affichage du cache, mise à jour en cours");
+}
+
+/**
+ * Enregistre l'état affiché du dépôt courant (voir StatusCache::save).
+ */
+void MainWindow::saveCache()
+{
+    if(!m_cache.isValid())
+        return;
+    CachedStatus cached;
+    cached.staged = m_stagedModel->items();
+    cached.unstaged = m_unstagedModel->items();
+    cached.unmerged = m_unmerged;
+    cached.refs = m_refs->snapshot();
+    cached.stash = ui->pushButton_pop->isEnabled();
+    m_cache.save(cached);
 }
 
 /**
- * @param list_view QListWidget d'où proviennent les items
- * @param only_files Booléen de sélection de la forme de sortie
- * @return Liste des éléments
+ * @param list_view Vue d'où proviennent les éléments
+ * @return Liste des fichiers sélectionnés
  *
- * Renvoie la liste des éléments dans le QListWidget @c list_view sous forme
- * d'une liste de chaînes de caractères. Si @c only_files est passé à @b true,
- * cette liste ne contient pas l'état des fichiers de cette liste.
+ * Renvoie la liste des chemins des fichiers sélectionnés dans la vue
+ * @c list_view.
  */
-QStringList MainWindow::getAllItems(QListWidget *list_view, bool only_files /*= true*/)
+QStringList MainWindow::getSelected(QListView *list_view)
 {
-    QStringList items;
-    for(int i = 0; i < list_view->count(); i++)
-    {
-        if(only_files) items << list_view->item(i)->text().split(':').at(1).simplified();
-        else items << list_view->item(i)->text();
-    }
-    return items;
+    const StatusModel* model = static_cast<const StatusModel*>(list_view->model());
+    return model->paths(list_view->selectionModel()->selectedIndexes());
 }
 
 /**
@@ -686,10 +1184,9 @@ void MainWindow::on_pushButton_branchMerge_clicked()
  */
 void MainWindow::on_pushButton_branchSwitch_clicked()
 {
-    if(action(QStringList() << "checkout" << ui->comboBox_branch->currentText()))
-    {
-        update_branches();
-    }
+    action(QStringList() << "checkout" << ui->comboBox_branch->currentText(), [this](const GitResult&) {
+        m_refresh->request(RefreshCoalescer::Refs | RefreshCoalescer::Status | RefreshCoalescer::Untracked);
+    });
 }
 
 /**
@@ -724,7 +1221,8 @@ void MainWindow::on_comboBox_branch_currentIndexChanged(const QString &arg1)
  * des actions supplémentaires :
  * @li @b push : ajout du dépôt distant dans la commande
  * @li création : émission du signal MainWindow::tag_created en fin d'exécution
- * @li par défaut : émission du signal MainWindow::tag_update en fin d'exécution
+ * @li par défaut : mise à jour des références (signal MainWindow::refs_update)
+ * en fin d'exécution
  */
 void MainWindow::action_tags(QStringList args)
 {
@@ -734,12 +1232,10 @@ void MainWindow::action_tags(QStringList args)
         {
             args << ui->comboBox_remote->currentText() << "--tags";
         }
-        if(action(args))
-        {
-            if(m_output.simplified() == "") emit tag_created(); // Création d'un nouveau tag
-            while(!action(QStringList() << "tag")){}
-            emit tag_update(m_output.split('\n'));
-        }
+        action(args, [this](const GitResult& result) {
+            if(result.outputText().simplified() == "") emit tag_created(); // Création d'un nouveau tag
+            m_refresh->request(RefreshCoalescer::Refs);
+        });
     }
 }
 
@@ -748,19 +1244,16 @@ void MainWindow::action_tags(QStringList args)
  *
  * Ce connecteur est appelé par l'émission du signal BranchesWindow::action.@n
  * La commande git contenue dans le paramètre @c args est exécutée par un
- * appel à la fonction MainWindow::action. Le signal MainWindow::branch_update est
- * émit en fin d'exécution.
+ * appel à la fonction MainWindow::action. Les références sont mises à jour en
+ * fin d'exécution (signal MainWindow::refs_update).
  */
 void MainWindow::action_branch(QStringList args)
 {
     if(args.length() > 0)
     {
-        if(action(args))
-        {
-            while(!action(QStringList() << "branch")){}
-            emit branch_update(m_output.split('\n'));
-            update_branches();
-        }
+        action(args, [this](const GitResult&) {
+            m_refresh->request(RefreshCoalescer::Refs);
+        });
     }
 }
 
@@ -769,10 +1262,7 @@ void MainWindow::on_toolButton_gitDir_clicked()
     QString dirName = QFileDialog::getExistingDirectory(this, "Dossier racine Git", qCtx->currentGitDir());
     if(dirName != "")
     {
-        if(setGitDir(dirName))
-        {
-            update_all();
-        }
+        setGitDir(dirName);
     }
 }
 
@@ -785,33 +1275,242 @@ void MainWindow::on_checkBox_autoRefresh_stateChanged(int arg1)
 {
     bool bChecked = arg1 == Qt::Checked;
     qCtx->setTimer(bChecked);
-    if(bChecked)
+    scheduleTick();
+    ui->spinBox_timerTime->setVisible(bChecked);
+}
+
+void MainWindow::on_spinBox_timerTime_valueChanged(int arg1)
+{
+    qCtx->setTimerTime(arg1);
+    scheduleTick();
+}
+
+/**
+ * @return Intervalle du prochain tick du timer (ms)
+ *
+ * L'intervalle choisi par l'utilisateur est une borne inférieure : il est
+ * allongé pour que le status ne dépasse pas 1/TIMER_COST_FACTOR du temps,
+ * d'après sa durée lissée, puis multiplié par TIMER_INACTIVE_FACTOR si la
+ * fenêtre n'est pas active. Le résultat est borné à TIMER_MAX_INTERVAL
+ * secondes, sans jamais descendre sous l'intervalle de l'utilisateur.
+ */
+int MainWindow::tickInterval() const
+{
+    qint64 interval = qint64(qCtx->timerTime()) * 1000;
+    interval = qMax(interval, m_statusCost * TIMER_COST_FACTOR);
+    if(!isActiveWindow())
+        interval *= TIMER_INACTIVE_FACTOR;
+    interval = qMin(interval, qint64(TIMER_MAX_INTERVAL) * 1000);
+    return int(qMax(interval, qint64(qCtx->timerTime()) * 1000));
+}
+
+/**
+ * Arme le timer de rafraîchissement pour un seul tick, avec l'intervalle
+ * calculé par MainWindow::tickInterval, et démarre la recherche périodique
+ * des fichiers non suivis (voir MainWindow::update_untracked). Les timers
+ * restent arrêtés si le rafraîchissement automatique est désactivé, si le
+ * dossier n'est pas un dépôt Git ou si la fenêtre est cachée ou réduite.
+ * Si un status est en cours, le timer sera réarmé à la fin de ce status, ce
+ * qui empêche deux ticks de se chevaucher.
+ */
+void MainWindow::scheduleTick()
+{
+    m_timer.stop();
+    if(!qCtx->timer() || !m_bInGitDir || !isVisible() || isMinimized())
     {
-        m_timer.start();
+        m_untrackedTimer.stop();
+        return;
     }
-    else
+    if(!m_untrackedTimer.isActive())
+        m_untrackedTimer.start(qCtx->untrackedTime() * 1000);
+    if(m_bStatusPending)
+        return;
+    int interval = tickInterval();
+    if(interval != m_timer.interval())
+    {
+        qLog->debug("Rafraîchissement auto : intervalle de", interval, "ms (status lissé :",
+                    m_statusCost, "ms)");
+    }
+    m_timer.start(interval);
+}
+
+/**
+ * @param event Evénement de changement d'état
+ *
+ * Suspend le rafraîchissement automatique quand la fenêtre est réduite. Au
+ * retour de l'activation, lance immédiatement un status si aucun n'est en
+ * cours, puis le timer reprend son intervalle normal.
+ */
+void MainWindow::changeEvent(QEvent* event)
+{
+    QMainWindow::changeEvent(event);
+    if(event->type() == QEvent::ActivationChange && isActiveWindow() &&
+       qCtx->timer() && m_bInGitDir && !m_bStatusPending)
     {
+        // Le dossier de travail a pu changer pendant l'inactivité : status forcé
         m_timer.stop();
+        m_lastAutoRefresh.invalidate();
+        timer_tick();
+    }
+    else if(event->type() == QEvent::ActivationChange || event->type() == QEvent::WindowStateChange)
+    {
+        scheduleTick();
     }
-    ui->spinBox_timerTime->setVisible(bChecked);
 }
 
-void MainWindow::on_spinBox_timerTime_valueChanged(int arg1)
+/**
+ * @param event Evénement d'affichage
+ *
+ * Réarme le timer de rafraîchissement à l'affichage de la fenêtre. Au premier
+ * affichage, surveille l'exposition de la fenêtre native pour détecter le
+ * premier dessin (voir MainWindow::eventFilter).
+ */
+void MainWindow::showEvent(QShowEvent* event)
+{
+    QMainWindow::showEvent(event);
+    if(!m_bFirstPaint && windowHandle())
+        windowHandle()->installEventFilter(this);
+    scheduleTick();
+}
+
+/**
+ * @param watched Objet surveillé
+ * @param event Evénement reçu
+ * @return @c false : l'événement est toujours transmis
+ *
+ * Le dessin de la fenêtre a lieu pendant le traitement de sa première
+ * exposition : MainWindow::first_paint est appelée au tour de boucle
+ * d'événements suivant.
+ */
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    if(watched == windowHandle() && event->type() == QEvent::Expose && windowHandle()->isExposed())
+    {
+        windowHandle()->removeEventFilter(this);
+        QTimer::singleShot(0, this, &MainWindow::first_paint);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+/**
+ * Ce connecteur est activé une seule fois, après le premier dessin de la
+ * fenêtre.@n
+ * Enregistre la phase @c startup/first-paint (depuis l'origine du Tracer),
+ * lance la vérification du dépôt en démarrage différé, puis émet le signal
+ * MainWindow::firstPaint.
+ */
+void MainWindow::first_paint()
 {
+    if(m_bFirstPaint)
+        return;
+    m_bFirstPaint = true;
+    qTrace->record("startup/first-paint", 0, qTrace->now());
+    qLog->info("Premier affichage après", qTrace->now() / 1000000, "ms");
+    if(qCtx->deferredStartup())
+        checkForGitDir();
+    emit firstPaint();
+}
+
+/**
+ * @param event Evénement de masquage
+ *
+ * Suspend le rafraîchissement automatique tant que la fenêtre est cachée.
+ */
+void MainWindow::hideEvent(QHideEvent* event)
+{
+    QMainWindow::hideEvent(event);
     m_timer.stop();
-    m_timer.setInterval(arg1 * 1000);
-    qCtx->setTimerTime(arg1);
-    on_checkBox_autoRefresh_stateChanged(ui->checkBox_autoRefresh->checkState());
+    m_untrackedTimer.stop();
+}
+
+/**
+ * @param arg1 Nouvel état de la case
+ *
+ * Ce connecteur est activé en cas de changement d'état de la case cochable
+ * Surveillance.@n
+ * Active ou désactive le rafraîchissement sur modification des fichiers du
+ * dépôt (voir RepoWatcher). Le rafraîchissement périodique reste indépendant
+ * et peut servir de secours sur les systèmes de fichiers réseau.
+ */
+void MainWindow::on_checkBox_watch_stateChanged(int arg1)
+{
+    bool bChecked = arg1 == Qt::Checked;
+    qCtx->setWatch(bChecked);
+    if(bChecked && m_bInGitDir)
+    {
+        m_watcher->start();
+    }
+    else
+    {
+        m_watcher->stop();
+    }
+}
+
+/**
+ * @param changes Combinaison de RepoWatcher::Change
+ *
+ * Ce connecteur est activé par la surveillance du dépôt après regroupement des
+ * modifications. Ne met à jour que les listes concernées.
+ */
+void MainWindow::repository_changed(int changes)
+{
+    // RepoWatcher::Change et RefreshCoalescer::Resource ont les mêmes valeurs
+    m_refresh->request(changes);
+}
+
+/**
+ * Ce connecteur est activé à chaque tick du timer de rafraîchissement.@n
+ * L'empreinte du dépôt (voir RepoFingerprint) est comparée à celle du tick
+ * précédent : le @b git @b status n'est lancé que si elle a changé ou si le
+ * dernier status date de plus de Context::maxStaleness secondes. Les
+ * branches ne sont mises à jour que si les références ont changé.@n
+ * Le timer est réarmé à la fin du status lancé, ou immédiatement si le tick
+ * a été ignoré (voir MainWindow::scheduleTick). Les requêtes passent par
+ * RefreshCoalescer, comme les autres demandes de rafraîchissement.
+ */
+void MainWindow::timer_tick()
+{
+    if(m_bStatusPending)
+    {
+        // Le status en cours réarmera le timer à sa fin
+        return;
+    }
+    int changes = m_fingerprint.update();
+    bool bStale = !m_lastAutoRefresh.isValid() ||
+                  m_lastAutoRefresh.elapsed() >= qint64(qCtx->maxStaleness()) * 1000;
+    if(changes == 0 && !bStale)
+    {
+        m_ticksSkipped++;
+        scheduleTick();
+    }
+    else
+    {
+        m_ticksRun++;
+        m_lastAutoRefresh.start();
+        m_refresh->request(RefreshCoalescer::Status | (changes & RepoWatcher::RefsChange));
+    }
+
+    if((m_ticksRun + m_ticksSkipped) % TICK_LOG_PERIOD == 0)
+    {
+        int total = m_ticksRun + m_ticksSkipped;
+        qLog->info("Rafraîchissement auto :", m_ticksRun, "status lancés,",
+                   m_ticksSkipped, "ignorés sur", total, "ticks",
+                   "(" + QString::number(100 * m_ticksSkipped / total) + "% ignorés)");
+    }
 }
 
 void MainWindow::on_pushButton_stash_clicked()
 {
-    action(QStringList() << "stash");
+    action(QStringList() << "stash", [this](const GitResult&) {
+        m_refresh->request(RefreshCoalescer::Status | RefreshCoalescer::Stash);
+    });
 }
 
 void MainWindow::on_pushButton_pop_clicked()
 {
-    action(QStringList() << "stash" << "pop");
+    action(QStringList() << "stash" << "pop", [this](const GitResult&) {
+        m_refresh->request(RefreshCoalescer::Status | RefreshCoalescer::Stash);
+    });
 }
 
 void MainWindow::on_pushButton_conflict_clicked()
@@ -857,3 +1556,71 @@ void MainWindow::status(const QString& msg)
     qLog->info("Status -", msg);
     ui->statusBar->showMessage(msg, 5000);
 }
+
+/**
+ * Ce connecteur est activé par l'action "Exporter la trace des performances"
+ * du menu contextuel de la fenêtre (Ctrl+Maj+T).@n
+ * Enregistre les durées mesurées par le Tracer au format JSON de Chrome,
+ * lisible dans chrome://tracing ou Perfetto.
+ */
+void MainWindow::export_trace()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Exporter la trace", "GitIHM-trace.json", "Trace (*.json)");
+    if(fileName.isEmpty())
+        return;
+    if(qTrace->exportChromeTrace(fileName))
+    {
+        qLog->info("Trace exportée :", fileName);
+        status("Trace exportée : " + fileName);
+    }
+    else
+    {
+        qLog->error("Impossible d'écrire la trace :", fileName);
+        QMessageBox::critical(this, "Erreur", "Impossible d'écrire le fichier " + fileName);
+    }
+}
+
+/**
+ * @param job Commande à afficher
+ *
+ * Affiche la commande dans la barre de status avec le bouton d'annulation.
+ * La barre indique une activité jusqu'à la première ligne de progression de
+ * Git (voir GitJob::progress).
+ */
+void MainWindow::showProgress(GitJob* job)
+{
+    m_statusJob = job;
+    const QString command = "git " + job->args().at(0);
+    m_progress->setRange(0, 0);
+    m_progress->setFormat(command);
+    m_progress->setVisible(true);
+    m_cancel->setVisible(true);
+    connect(job, &GitJob::progress, this, [this, job, command](const QString& phase, int percent) {
+        if(m_statusJob != job)
+            return;
+        m_progress->setRange(0, 100);
+        m_progress->setValue(percent);
+        m_progress->setFormat(command + " - " + phase + " : %p%");
+    });
+}
+
+/**
+ * Masque la progression et le bouton d'annulation.
+ */
+void MainWindow::hideProgress()
+{
+    m_statusJob = nullptr;
+    m_progress->setVisible(false);
+    m_cancel->setVisible(false);
+}
+
+/**
+ * Ce connecteur est activé par un clic souris de l'utilisateur sur le bouton
+ * Annuler de la barre de status.@n
+ * Annule la commande affichée, qu'elle soit en attente ou en cours.
+ */
+void MainWindow::cancel_command()
+{
+    if(m_statusJob)
+        m_statusJob->cancel();
+}
@@ -0,0 +1,140 @@
+#include "OutputViewer.hpp"
+#include "ui_OutputViewer.h"
+
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextCodec>
+#include <QTextCursor>
+#include <QTextDocument>
+
+/**
+ * @param parent Le QWidget parent de cette fenêtre
+ * @param title Titre de la fenêtre
+ *
+ * Contructeur de la classe OutputViewer.
+ */
+OutputViewer::OutputViewer(QWidget *parent, const QString& title) :
+    QMainWindow(parent),
+    ui(new Ui::OutputViewer),
+    m_decoder(QTextCodec::codecForName("UTF-8")->makeDecoder()),
+    m_bytes(0),
+    m_lines(0)
+{
+    ui->setupUi(this);
+
+    setWindowTitle(title);
+    setAttribute(Qt::WA_DeleteOnClose);
+    setAttribute(Qt::WA_QuitOnClose, false);
+    ui->plainTextEdit_output->setMaximumBlockCount(OUTPUT_MAX_LINES);
+}
+
+/**
+ * Destructeur de la classe OutputViewer.
+ */
+OutputViewer::~OutputViewer()
+{
+    delete m_decoder;
+    delete ui;
+}
+
+/**
+ * @param chunk Partie de la sortie
+ *
+ * Ce connecteur est activé à chaque réception d'une partie de la sortie
+ * (voir GitJob::outputReady).@n
+ * Affiche les lignes complètes et conserve la dernière ligne incomplète
+ * jusqu'à la partie suivante.
+ */
+void OutputViewer::append(const QByteArray& chunk)
+{
+    if(!isVisible())
+        show();
+    m_bytes += chunk.size();
+    m_partial += m_decoder->toUnicode(chunk);
+
+    int idx = m_partial.lastIndexOf('\n');
+    if(idx == -1 && m_partial.length() < OUTPUT_MAX_PARTIAL)
+    {
+        updateState("En cours...");
+        return;
+    }
+    if(idx == -1)
+        idx = m_partial.length();
+
+    // Défilement automatique seulement si l'utilisateur est en bas de la sortie
+    QScrollBar* bar = ui->plainTextEdit_output->verticalScrollBar();
+    bool bBottom = bar->value() == bar->maximum();
+    QString lines = m_partial.left(idx);
+    m_lines += lines.count('\n') + 1;
+    ui->plainTextEdit_output->appendPlainText(lines);
+    m_partial.remove(0, idx + 1);
+    trim();
+    if(bBottom)
+        bar->setValue(bar->maximum());
+    updateState("En cours...");
+}
+
+/**
+ * @param result Résultat de la commande
+ *
+ * Ce connecteur est activé à la fin de la commande.@n
+ * Affiche la dernière ligne et le bilan de la commande. La fenêtre est
+ * détruite si la commande n'a rien écrit.
+ */
+void OutputViewer::finish(const GitResult& result)
+{
+    if(m_bytes == 0)
+    {
+        deleteLater();
+        return;
+    }
+    if(!m_partial.isEmpty())
+    {
+        ui->plainTextEdit_output->appendPlainText(m_partial);
+        m_lines++;
+        m_partial.clear();
+        trim();
+    }
+    updateState("Terminé (code retour : " + QString::number(result.exitCode) + ")");
+}
+
+/**
+ * Supprime les lignes les plus anciennes tant que l'affichage dépasse
+ * #OUTPUT_MAX_CHARS caractères. La dernière ligne est toujours conservée.
+ */
+void OutputViewer::trim()
+{
+    QTextDocument* doc = ui->plainTextEdit_output->document();
+    int excess = doc->characterCount() - OUTPUT_MAX_CHARS;
+    if(excess <= 0)
+        return;
+    QTextBlock block = doc->firstBlock();
+    int removed = 0;
+    while(removed < excess && block.isValid() && block != doc->lastBlock())
+    {
+        removed += block.length();
+        block = block.next();
+    }
+    if(removed == 0)
+        return;
+    QTextCursor cursor(doc);
+    cursor.setPosition(0);
+    cursor.setPosition(block.position(), QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+}
+
+/**
+ * @param state Etat de la commande
+ *
+ * Affiche l'état de la commande, le volume reçu et, si des lignes ont été
+ * supprimées de l'affichage, le nombre de lignes affichées et les limites.
+ */
+void OutputViewer::updateState(const QString& state)
+{
+    QString text = state + " - " + QString::number(m_bytes / 1024) + " Ko, " + QString::number(m_lines) + " lignes";
+    int shown = ui->plainTextEdit_output->document()->blockCount();
+    if(m_lines > shown)
+        text += " (" + QString::number(shown) + " dernières affichées, limites : " + QString::number(OUTPUT_MAX_LINES)
+                + " lignes, " + QString::number(OUTPUT_MAX_CHARS / 1024) + " K caractères)";
+    ui->label_state->setText(text);
+}
@@ -0,0 +1,233 @@
+#include "PerfDock.hpp"
+#include "ui_PerfDock.h"
+
+#include <QHeaderView>
+#include <algorithm>
+#include "Context.hpp"
+
+#if defined(Q_OS_UNIX)
+    #include <sys/resource.h>
+#elif defined(Q_OS_WIN)
+    #include <windows.h>
+#endif
+
+/**
+ * @param parent Le QWidget parent de ce panneau
+ *
+ * Contructeur de la classe PerfDock.@n
+ * Enregistre toutes les commandes terminées par GitExecutor. Les tableaux ne
+ * sont mis à jour que lorsque le panneau est visible.
+ */
+PerfDock::PerfDock(QWidget *parent) :
+    QDockWidget(parent),
+    ui(new Ui::PerfDock),
+    m_bDirty(false)
+{
+    ui->setupUi(this);
+    ui->tableWidget_stats->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->tableWidget_recent->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->tableWidget_recent->horizontalHeader()->setStretchLastSection(true);
+
+    m_clock.start();
+    connect(qGit, &GitExecutor::jobFinished, this, &PerfDock::job_finished);
+    connect(&m_timer, &QTimer::timeout, this, &PerfDock::refresh);
+    m_timer.start(PERF_REFRESH_MS);
+}
+
+/**
+ * Destructeur de la classe PerfDock.
+ */
+PerfDock::~PerfDock()
+{
+    delete ui;
+}
+
+/**
+ * @param result Résultat de la commande
+ *
+ * Ce connecteur est activé à la fin de chaque commande Git.@n
+ * Conserve le résumé de la commande et sa durée.
+ */
+void PerfDock::job_finished(const GitResult& result)
+{
+    Invocation invocation;
+    invocation.command = result.args.join(' ');
+    invocation.elapsed = result.elapsed;
+    invocation.waited = result.waited;
+    invocation.outputSize = result.outputSize;
+    invocation.errorSize = result.error.size();
+    invocation.exitCode = result.exitCode;
+    m_recent.prepend(invocation);
+    if(m_recent.length() > PERF_RECENT)
+        m_recent.removeLast();
+
+    Samples& samples = m_samples[GitExecutor::commandName(result.args)];
+    if(samples.durations.length() < PERF_SAMPLES)
+        samples.durations.append(result.elapsed);
+    else
+        samples.durations[samples.count % PERF_SAMPLES] = result.elapsed;
+    samples.count++;
+
+    Busy busy;
+    busy.end = m_clock.elapsed();
+    busy.elapsed = result.elapsed;
+    m_busy.enqueue(busy);
+    m_bDirty = true;
+}
+
+/**
+ * @param event Evénement d'affichage
+ *
+ * Met à jour les tableaux dès l'affichage du panneau.
+ */
+void PerfDock::showEvent(QShowEvent* event)
+{
+    QDockWidget::showEvent(event);
+    m_bDirty = true;
+    refresh();
+}
+
+/**
+ * Ce connecteur est activé toutes les #PERF_REFRESH_MS millisecondes.@n
+ * Echantillonne le temps CPU puis, si le panneau est visible, met à jour le
+ * coût du rafraîchissement et, si de nouvelles commandes ont été reçues, les
+ * tableaux.
+ */
+void PerfDock::refresh()
+{
+    qint64 now = m_clock.elapsed();
+    CpuSample sample;
+    sample.wall = now;
+    sample.cpu = cpuTime();
+    m_cpu.enqueue(sample);
+    while(m_cpu.length() > 2 && now - m_cpu.head().wall > PERF_WINDOW_MS)
+        m_cpu.dequeue();
+    while(!m_busy.isEmpty() && now - m_busy.head().end > PERF_WINDOW_MS)
+        m_busy.dequeue();
+
+    if(!isVisible())
+        return;
+
+    // Coût du rafraîchissement sur la fenêtre : les commandes parallèles se
+    // recouvrent, l'occupation est la longueur de l'union de leurs intervalles
+    qint64 window = qMin(now, qint64(PERF_WINDOW_MS));
+    QVector<QPair<qint64, qint64>> intervals;
+    intervals.reserve(m_busy.length());
+    for(const Busy& busy : m_busy)
+    {
+        intervals.append(qMakePair(qMax(busy.end - busy.elapsed, now - window), busy.end));
+    }
+    std::sort(intervals.begin(), intervals.end());
+    qint64 busyTime = 0;
+    qint64 covered = now - window;
+    for(const QPair<qint64, qint64>& interval : intervals)
+    {
+        if(interval.second > covered)
+        {
+            busyTime += interval.second - qMax(interval.first, covered);
+            covered = interval.second;
+        }
+    }
+    QString cost = "Dernière minute : " + QString::number(m_busy.length()) + " commandes, processus Git actifs "
+                   + QString::number(window > 0 ? 100.0 * busyTime / window : 0, 'f', 1) + "% du temps";
+    const CpuSample& first = m_cpu.head();
+    if(sample.cpu >= 0 && sample.wall > first.wall)
+    {
+        cost += ", CPU " + QString::number(100.0 * (sample.cpu - first.cpu) / (sample.wall - first.wall), 'f', 1) + "%";
+    }
+
+    bool bSlow = false;
+    if(qCtx->timer() && m_samples.contains("status"))
+    {
+        qint64 interval = qint64(qCtx->timerTime()) * 1000;
+        qint64 p95 = percentile(m_samples.value("status").durations, 0.95);
+        bSlow = p95 * 2 > interval;
+        cost += "\nStatus p95 : " + QString::number(p95) + " ms pour un rafraîchissement toutes les "
+                + QString::number(qCtx->timerTime()) + " s";
+        if(bSlow)
+            cost += " : dépôt trop lent pour cet intervalle, qui sera allongé automatiquement";
+    }
+    ui->label_cost->setText(cost);
+    ui->label_cost->setStyleSheet(bSlow ? "color: rgb(255, 120, 60);" : "");
+
+    if(!m_bDirty)
+        return;
+    m_bDirty = false;
+
+    // Percentiles par type de commande
+    QStringList commands = m_samples.keys();
+    commands.sort();
+    ui->tableWidget_stats->setRowCount(commands.length());
+    for(int row = 0; row < commands.length(); row++)
+    {
+        const Samples& samples = m_samples.value(commands.at(row));
+        QStringList cells = QStringList() << commands.at(row) << QString::number(samples.count)
+                                          << QString::number(percentile(samples.durations, 0.5))
+                                          << QString::number(percentile(samples.durations, 0.95))
+                                          << QString::number(percentile(samples.durations, 0.99));
+        for(int col = 0; col < cells.length(); col++)
+        {
+            ui->tableWidget_stats->setItem(row, col, new QTableWidgetItem(cells.at(col)));
+        }
+    }
+
+    // Dernières commandes
+    ui->tableWidget_recent->setRowCount(m_recent.length());
+    for(int row = 0; row < m_recent.length(); row++)
+    {
+        const Invocation& invocation = m_recent.at(row);
+        QStringList cells = QStringList() << QString::number(invocation.elapsed) << QString::number(invocation.waited)
+                                          << QString::number(invocation.outputSize) << QString::number(invocation.errorSize)
+                                          << QString::number(invocation.exitCode) << "git " + invocation.command;
+        for(int col = 0; col < cells.length(); col++)
+        {
+            ui->tableWidget_recent->setItem(row, col, new QTableWidgetItem(cells.at(col)));
+        }
+    }
+}
+
+/**
+ * @param values Durées (copie triée localement)
+ * @param p Rang (entre 0 et 1)
+ * @return Percentile @c p des durées, 0 si la liste est vide
+ */
+qint64 PerfDock::percentile(QVector<qint64> values, double p)
+{
+    if(values.isEmpty())
+        return 0;
+    int idx = qMin(values.length() - 1, int(p * values.length()));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values.at(idx);
+}
+
+/**
+ * @return Temps CPU consommé par l'application et ses processus terminés (ms),
+ * -1 si non disponible
+ *
+ * Sous Windows, seul le temps de l'application est compté.
+ */
+qint64 PerfDock::cpuTime()
+{
+#if defined(Q_OS_UNIX)
+    qint64 total = 0;
+    struct rusage usage;
+    const int who[] = {RUSAGE_SELF, RUSAGE_CHILDREN};
+    for(int w : who)
+    {
+        if(getrusage(w, &usage) != 0)
+            return -1;
+        total += qint64(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 +
+                 (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    }
+    return total;
+#elif defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return -1;
+    quint64 k = (quint64(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    quint64 u = (quint64(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return qint64((k + u) / 10000);
+#else
+    return -1;
+#endif
+}
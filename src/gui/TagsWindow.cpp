@@ -4,7 +4,7 @@
 
 /**
  * @param parent Le QWidget parent de cette fenêtre
- * @param tags Liste de tags à afficher
+ * @param refs Références du dépôt contenant les tags à afficher
  *
  * Contructeur de la classe TagsWindow.@n
  * Ce constructeur hérite de celui de QMainWindow et utilise le système des fichiers
@@ -12,12 +12,12 @@
  * Ce constructeur va appeler la fonction TagsWindow::update_tags pour initialiser la
  * liste des tags et rend ensuite la fenêtre modale.
  */
-TagsWindow::TagsWindow(QWidget *parent, QStringList tags) :
+TagsWindow::TagsWindow(QWidget *parent, const RefSnapshot& refs) :
     QMainWindow(parent),
     ui(new Ui::TagsWindow)
 {
     ui->setupUi(this);
-    update_tags(tags);
+    update_tags(refs);
 
     this->setWindowModality(Qt::ApplicationModal);
     this->setAttribute(Qt::WA_QuitOnClose, false);
@@ -32,21 +32,14 @@ TagsWindow::~TagsWindow()
 }
 
 /**
- * @param tags Nouvelle liste des tags
+ * @param refs Nouvelles références du dépôt
  *
  * Met à jour la liste des tags de la fenêtre en la remplaçant par celle
- * passée en argument.
+ * des références passées en argument.
  */
-void TagsWindow::update_tags(QStringList tags)
+void TagsWindow::update_tags(const RefSnapshot& refs)
 {
-    for(int i = 0; i < tags.length(); i++)
-    {
-        if(tags[i].simplified() == "")
-        {
-            tags.removeAt(i);
-            i--;
-        }
-    }
+    QStringList tags = refs.tags();
     ui->listWidget_tags->clear();
     ui->listWidget_tags->addItems(tags);
     ui->listWidget_tags->sortItems();
@@ -0,0 +1,132 @@
+#include "WorkspaceDock.hpp"
+#include "ui_WorkspaceDock.h"
+
+#include <QDir>
+#include <QFileDialog>
+#include <QHeaderView>
+#include "Context.hpp"
+
+/**
+ * @param workspace Espace de travail à afficher
+ * @param parent Le QWidget parent de ce panneau
+ *
+ * Contructeur de la classe WorkspaceDock.
+ */
+WorkspaceDock::WorkspaceDock(Workspace* workspace, QWidget *parent) :
+    QDockWidget(parent),
+    ui(new Ui::WorkspaceDock),
+    m_workspace(workspace)
+{
+    ui->setupUi(this);
+    ui->tableWidget_repos->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->tableWidget_repos->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    connect(m_workspace, &Workspace::changed, this, &WorkspaceDock::workspace_changed);
+    connect(m_workspace, &Workspace::updated, this, &WorkspaceDock::workspace_updated);
+    workspace_changed();
+}
+
+/**
+ * Destructeur de la classe WorkspaceDock.
+ */
+WorkspaceDock::~WorkspaceDock()
+{
+    delete ui;
+}
+
+/**
+ * Ce connecteur est activé à chaque ajout ou retrait de dépôt et au
+ * changement du dépôt au premier plan.@n
+ * Reconstruit toutes les lignes.
+ */
+void WorkspaceDock::workspace_changed()
+{
+    ui->tableWidget_repos->setRowCount(m_workspace->summaries().length());
+    for(int row = 0; row < m_workspace->summaries().length(); row++)
+    {
+        workspace_updated(row);
+    }
+}
+
+/**
+ * @param index Position du dépôt
+ *
+ * Ce connecteur est activé à chaque mise à jour du résumé d'un dépôt.
+ */
+void WorkspaceDock::workspace_updated(int index)
+{
+    if(index >= ui->tableWidget_repos->rowCount())
+        return;
+    const RepoSummary& summary = m_workspace->summaries().at(index);
+    QStringList cells;
+    cells << QDir(summary.path).dirName();
+    if(!summary.valid)
+    {
+        cells << (summary.pending || summary.error.isEmpty() ? QString("...") : QString("Erreur"))
+              << "" << "" << "" << "" << "";
+    }
+    else
+    {
+        cells << (summary.branch.isEmpty() ? QString("HEAD détachée") : summary.branch)
+              << QString::number(summary.staged) << QString::number(summary.unstaged)
+              << QString::number(summary.untracked) << QString::number(summary.conflicts)
+              << (summary.hasUpstream ? "+" + QString::number(summary.ahead) + " / -" + QString::number(summary.behind) : QString("-"));
+    }
+
+    bool bForeground = summary.path == m_workspace->foreground();
+    QString tooltip = summary.path;
+    if(!summary.error.isEmpty())
+        tooltip += "\n" + summary.error;
+    else if(summary.updated.isValid())
+        tooltip += "\nMis à jour à " + summary.updated.toString("HH:mm:ss");
+    for(int col = 0; col < cells.length(); col++)
+    {
+        QTableWidgetItem* item = new QTableWidgetItem(cells.at(col));
+        item->setToolTip(tooltip);
+        if(bForeground)
+        {
+            QFont font = item->font();
+            font.setBold(true);
+            item->setFont(font);
+        }
+        ui->tableWidget_repos->setItem(index, col, item);
+    }
+}
+
+/**
+ * Ce connecteur est activé par un clic souris de l'utilisateur sur le
+ * bouton Ajouter.@n
+ * Ajoute un dépôt à l'espace de travail et enregistre la liste dans le
+ * contexte.
+ */
+void WorkspaceDock::on_pushButton_add_clicked()
+{
+    QString dir = QFileDialog::getExistingDirectory(this, "Ajouter un dépôt", qCtx->currentGitDir());
+    if(!dir.isEmpty() && m_workspace->add(dir))
+        qCtx->setWorkspace(m_workspace->repositories());
+}
+
+/**
+ * Ce connecteur est activé par un clic souris de l'utilisateur sur le
+ * bouton Retirer.@n
+ * Retire le dépôt sélectionné de l'espace de travail.
+ */
+void WorkspaceDock::on_pushButton_remove_clicked()
+{
+    int row = ui->tableWidget_repos->currentRow();
+    if(row < 0 || row >= m_workspace->summaries().length())
+        return;
+    m_workspace->remove(m_workspace->summaries().at(row).path);
+    qCtx->setWorkspace(m_workspace->repositories());
+}
+
+/**
+ * @param row Ligne du dépôt
+ *
+ * Ce connecteur est activé par un double-clic sur un dépôt.
+ */
+void WorkspaceDock::on_tableWidget_repos_cellDoubleClicked(int row, int)
+{
+    if(row >= 0 && row < m_workspace->summaries().length())
+        emit open(m_workspace->summaries().at(row).path);
+}
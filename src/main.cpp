@@ -3,26 +3,68 @@
 #include <QApplication>
 #include <QFile>
 #include <QStyleFactory>
+#include <QTextStream>
 #include "Logger.hpp"
+#include "Tracer.hpp"
 
 #define DARKSTYLE_FILE QString(":/darkstyle/darkstyle.qss")
 
 void setStyle();
+void setStyleSheet();
 
 int main(int argc, char *argv[])
 {
+    // Origine des dates du Tracer : démarrage du processus
+    qTrace->now();
     QApplication a(argc, argv);
+    QStringList args = a.arguments();
 
-    qLog->createLog("GitIHM.log");
+    // Le fichier INI est lu avant l'ouverture du journal pour en connaître le format :
+    // ses messages attendent l'ouverture du fichier dans le tampon du Logger
+    qLog->setRotation(qint64(qCtx->logMaxSize()) * 1024, qCtx->logMaxAge() * 3600, qCtx->logRetention());
+    if(qCtx->logBinary())
+        qLog->createLog("GitIHM.glog", false, Logger::Binary);
+    else
+        qLog->createLog("GitIHM.log");
+    qLog->setMinLevel(Logger::LogLevel(qCtx->logLevel()));
 
+    // En démarrage différé, la feuille de style est appliquée après le premier affichage
     setStyle();
+    if(!qCtx->deferredStartup())
+        setStyleSheet();
 
     MainWindow w;
+    if(qCtx->deferredStartup())
+        QObject::connect(&w, &MainWindow::firstPaint, &setStyleSheet);
+
+    // Mesure du démarrage : --startup-report écrit les dates du premier affichage
+    // et de la première mise à jour complète (µs) puis quitte l'application
+    if(args.contains("--startup-report"))
+    {
+        QObject::connect(&w, &MainWindow::firstPaint, []() {
+            QTextStream(stdout) << "first-paint " << qTrace->now() / 1000 << endl;
+        });
+        QObject::connect(&w, &MainWindow::refreshed, &a, []() {
+            qTrace->record("startup/first-status", 0, qTrace->now());
+            QTextStream(stdout) << "first-status " << qTrace->now() / 1000 << endl;
+            qApp->quit();
+        });
+    }
     w.show();
 
     int returnCode = a.exec();
     qLog->info("Code retour de l'application", returnCode);
 
+    // Export de la trace des performances : --trace <fichier>
+    int idx = args.indexOf("--trace");
+    if(idx != -1 && idx + 1 < args.length())
+    {
+        if(qTrace->exportChromeTrace(args.at(idx + 1)))
+            qLog->info("Trace exportée :", args.at(idx + 1));
+        else
+            qLog->error("Impossible d'écrire la trace :", args.at(idx + 1));
+    }
+
     qCtx->save();
     qLog->close();
     return returnCode;
@@ -60,10 +102,7 @@ void setStyle()
         darkPalette.setColor(QPalette::HighlightedText,Qt::white);
         darkPalette.setColor(QPalette::Disabled,QPalette::HighlightedText,QColor(127,127,127));
         qApp->setPalette(darkPalette);
-
-        QString style = QString(file.readAll());
         file.close();
-        qApp->setStyleSheet(style);
 
         qLog->info("Style créé :", file.fileName());
     }
@@ -71,4 +110,17 @@ void setStyle()
     {
         qLog->error("Impossible de créer le style :", file.fileName());
     }
+}
+
+void setStyleSheet()
+{
+    TraceSpan span("startup/stylesheet");
+    QFile file(DARKSTYLE_FILE);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QString style = QString(file.readAll());
+        file.close();
+        qApp->setStyleSheet(style);
+        qLog->info("Feuille de style appliquée :", file.fileName());
+    }
 }
\ No newline at end of file
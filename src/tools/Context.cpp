@@ -1,5 +1,6 @@
 #include "Context.hpp"
 #include "Logger.hpp"
+#include "GitExecutor.hpp"
 
 #include <QFile>
 #include <QTextStream>
@@ -8,6 +9,23 @@
 #define KW_GITDIR       "git-dir"
 #define KW_TIMER        "timer-enable"
 #define KW_TIMERTIME    "timer-seconds"
+#define KW_PROCESSPOOL  "process-pool"
+#define KW_WATCH        "watch-enable"
+#define KW_WATCHTREE    "watch-worktree"
+#define KW_STALENESS    "max-staleness"
+#define KW_LOGLEVEL     "log-level"
+#define KW_LOGSIZE      "log-max-kb"
+#define KW_LOGAGE       "log-max-hours"
+#define KW_LOGRETENTION "log-retention"
+#define KW_LOGBINARY    "log-binary"
+#define KW_TIMEOUTQUERY "timeout-query"
+#define KW_TIMEOUTLOCAL "timeout-local"
+#define KW_TIMEOUTNET   "timeout-network"
+#define KW_WORKSPACE    "workspace-repo"
+#define KW_DEFERSTART   "deferred-startup"
+#define KW_UNTRACKED    "untracked-seconds"
+#define KW_UNTRACKEDCACHE "untracked-cache"
+#define KW_FSMONITOR    "fsmonitor"
 
 Context* Context::m_instance = nullptr;
 
@@ -34,7 +52,26 @@ void Context::save()
 
         stream << KW_GITDIR << '=' << m_currentGitDir << endl;
         stream << KW_TIMER << '=' << (m_bTimerAuto ? "true" : "false") << endl;
-        stream << KW_TIMERTIME << '=' << m_timerRefresh;
+        stream << KW_TIMERTIME << '=' << m_timerRefresh << endl;
+        stream << KW_PROCESSPOOL << '=' << m_processPool << endl;
+        stream << KW_WATCH << '=' << (m_bWatch ? "true" : "false") << endl;
+        stream << KW_WATCHTREE << '=' << (m_bWatchWorkTree ? "true" : "false") << endl;
+        stream << KW_STALENESS << '=' << m_maxStaleness << endl;
+        stream << KW_LOGLEVEL << '=' << m_logLevel << endl;
+        stream << KW_LOGSIZE << '=' << m_logMaxSize << endl;
+        stream << KW_LOGAGE << '=' << m_logMaxAge << endl;
+        stream << KW_LOGRETENTION << '=' << m_logRetention << endl;
+        stream << KW_LOGBINARY << '=' << (m_bLogBinary ? "true" : "false") << endl;
+        stream << KW_TIMEOUTQUERY << '=' << m_timeoutQuery << endl;
+        stream << KW_TIMEOUTLOCAL << '=' << m_timeoutLocal << endl;
+        stream << KW_TIMEOUTNET << '=' << m_timeoutNetwork << endl;
+        stream << KW_DEFERSTART << '=' << (m_bDeferredStartup ? "true" : "false") << endl;
+        stream << KW_UNTRACKED << '=' << m_untrackedRefresh << endl;
+        stream << KW_UNTRACKEDCACHE << '=' << featureName(m_untrackedCache) << endl;
+        stream << KW_FSMONITOR << '=' << featureName(m_fsmonitor);
+        // Une ligne par dépôt de l'espace de travail
+        for(const QString& repo : m_workspace)
+            stream << endl << KW_WORKSPACE << '=' << repo;
         file.close();
     }
     else
@@ -48,6 +85,23 @@ void Context::init()
     m_currentGitDir = ".";
     m_bTimerAuto = false;
     m_timerRefresh = 1;
+    m_processPool = 3;
+    m_bWatch = false;
+    m_bWatchWorkTree = false;
+    m_maxStaleness = 10;
+    m_logLevel = 0;
+    m_logMaxSize = 10240;
+    m_logMaxAge = 24;
+    m_logRetention = 5;
+    m_bLogBinary = false;
+    m_timeoutQuery = GIT_TIMEOUT_QUERY;
+    m_timeoutLocal = GIT_TIMEOUT_LOCAL;
+    m_timeoutNetwork = GIT_TIMEOUT_NETWORK;
+    m_workspace.clear();
+    m_bDeferredStartup = false;
+    m_untrackedRefresh = 30;
+    m_untrackedCache = Auto;
+    m_fsmonitor = Auto;
 
     qLog->info("Lecture du fichier INI :", INIT_FILE);
     QFile file(INIT_FILE);
@@ -80,6 +134,72 @@ void Context::init()
                     if(m_timerRefresh < 1)
                         m_timerRefresh = 1;
                 }
+                else if(key == KW_WATCH) m_bWatch = value == "true";
+                else if(key == KW_WATCHTREE) m_bWatchWorkTree = value == "true";
+                else if(key == KW_STALENESS)
+                {
+                    m_maxStaleness = value.toInt();
+                    // Gestion borne inf
+                    if(m_maxStaleness < 1)
+                        m_maxStaleness = 1;
+                }
+                else if(key == KW_LOGLEVEL)
+                {
+                    m_logLevel = value.toInt();
+                    // Gestion bornes (voir Logger::LogLevel)
+                    if(m_logLevel < 0)
+                        m_logLevel = 0;
+                    else if(m_logLevel > 4)
+                        m_logLevel = 4;
+                }
+                else if(key == KW_LOGSIZE)
+                {
+                    m_logMaxSize = value.toInt();
+                    // Gestion borne inf (0 : illimitée)
+                    if(m_logMaxSize < 0)
+                        m_logMaxSize = 0;
+                }
+                else if(key == KW_LOGAGE)
+                {
+                    m_logMaxAge = value.toInt();
+                    // Gestion borne inf (0 : illimité)
+                    if(m_logMaxAge < 0)
+                        m_logMaxAge = 0;
+                }
+                else if(key == KW_LOGRETENTION)
+                {
+                    m_logRetention = value.toInt();
+                    // Gestion bornes
+                    if(m_logRetention < 0)
+                        m_logRetention = 0;
+                    else if(m_logRetention > 99)
+                        m_logRetention = 99;
+                }
+                else if(key == KW_LOGBINARY) m_bLogBinary = value == "true";
+                // Délais maximaux en secondes (0 : aucun)
+                else if(key == KW_TIMEOUTQUERY) m_timeoutQuery = qMax(0, value.toInt());
+                else if(key == KW_TIMEOUTLOCAL) m_timeoutLocal = qMax(0, value.toInt());
+                else if(key == KW_TIMEOUTNET) m_timeoutNetwork = qMax(0, value.toInt());
+                else if(key == KW_DEFERSTART) m_bDeferredStartup = value == "true";
+                else if(key == KW_UNTRACKED)
+                {
+                    m_untrackedRefresh = value.toInt();
+                    // Gestion borne inf
+                    if(m_untrackedRefresh < 1)
+                        m_untrackedRefresh = 1;
+                }
+                else if(key == KW_UNTRACKEDCACHE) m_untrackedCache = parseFeature(value);
+                else if(key == KW_FSMONITOR) m_fsmonitor = parseFeature(value);
+                else if(key == KW_WORKSPACE && !value.isEmpty()) m_workspace.append(value);
+                else if(key == KW_PROCESSPOOL)
+                {
+                    m_processPool = value.toInt();
+                    // Gestion bornes (voir GIT_MIN_PARALLEL)
+                    if(m_processPool < 2)
+                        m_processPool = 2;
+                    else if(m_processPool > 16)
+                        m_processPool = 16;
+                }
             }
         }
     }
@@ -87,4 +207,18 @@ void Context::init()
     {
         qLog->error("Echec d'ouverture du fichier");
     }
-}
\ No newline at end of file
+}
+
+Context::Feature Context::parseFeature(const QString& value)
+{
+    if(value == "true") return On;
+    else if(value == "false") return Off;
+    else return Auto;
+}
+
+const char* Context::featureName(Feature mode)
+{
+    if(mode == On) return "true";
+    else if(mode == Off) return "false";
+    else return "auto";
+}
@@ -0,0 +1,545 @@
+#include "GitExecutor.hpp"
+#include "Logger.hpp"
+#include "Tracer.hpp"
+
+#include <QRegularExpression>
+
+GitExecutor* GitExecutor::m_instance = nullptr;
+
+/**
+ * @param dir Dossier d'exécution de la commande
+ * @param args Arguments de la commande
+ * @param mode Type d'accès au dépôt (voir GitExecutor::Mode)
+ * @param parent Objet parent
+ *
+ * Contructeur de la classe GitJob.@n
+ * Démarre le chronomètre du temps d'attente.
+ */
+GitJob::GitJob(const QString& dir, const QStringList& args, int mode, QObject* parent) :
+    QObject(parent),
+    m_mode(mode),
+    m_bBackground(false),
+    m_bOptionalLocks(false),
+    m_process(nullptr),
+    m_traceStart(qTrace->now()),
+    m_streamCap(-1)
+{
+    m_result.args = args;
+    m_result.workingDirectory = dir;
+    m_clock.start();
+}
+
+/**
+ * Lit la partie disponible de la sortie standard d'une commande en flux : elle
+ * est conservée dans la limite de GitJob::m_streamCap octets puis transmise par
+ * le signal GitJob::outputReady.
+ */
+void GitJob::readOutput()
+{
+    QByteArray chunk = m_process->readAllStandardOutput();
+    if(chunk.isEmpty())
+        return;
+    m_result.outputSize += chunk.size();
+    qint64 room = m_streamCap - m_result.output.size();
+    if(room < chunk.size())
+        m_result.truncated = true;
+    if(room > 0)
+        m_result.output.append(chunk.constData(), int(qMin(room, qint64(chunk.size()))));
+    emit outputReady(chunk);
+}
+
+/**
+ * Lit la partie disponible de l'erreur standard. Chaque ligne, terminée par
+ * un saut de ligne ou par un retour chariot (mise à jour d'une ligne de
+ * progression), est analysée par GitJob::parseProgress. Seules les lignes
+ * terminées par un saut de ligne sont conservées dans GitResult::error.
+ */
+void GitJob::readError()
+{
+    m_errorLine += m_process->readAllStandardError();
+    int start = 0;
+    for(int i = 0; i < m_errorLine.size(); i++)
+    {
+        char c = m_errorLine.at(i);
+        if(c != '\r' && c != '\n')
+            continue;
+        QByteArray line = m_errorLine.mid(start, i - start);
+        parseProgress(line);
+        if(c == '\n')
+        {
+            m_result.error += line;
+            m_result.error += '\n';
+        }
+        start = i + 1;
+    }
+    m_errorLine.remove(0, start);
+}
+
+/**
+ * @param line Ligne de l'erreur standard
+ *
+ * Emet le signal GitJob::progress si la ligne est une ligne de progression de
+ * Git, par exemple @c "Receiving objects:  45% (450/1000), 1.20 MiB | 2.00 MiB/s".
+ */
+void GitJob::parseProgress(const QByteArray& line)
+{
+    if(!line.contains('%'))
+        return;
+    static const QRegularExpression re("^(.*?):\\s+(\\d+)%");
+    QRegularExpressionMatch match = re.match(QString::fromUtf8(line));
+    if(match.hasMatch())
+        emit progress(match.captured(1).trimmed(), match.captured(2).toInt());
+}
+
+/**
+ * Annule la commande (voir GitExecutor::cancel).
+ */
+void GitJob::cancel()
+{
+    qGit->cancel(this);
+}
+
+GitExecutor::GitExecutor() :
+    QObject(nullptr),
+    m_maxParallel(GIT_MIN_PARALLEL),
+    m_version(-1)
+{
+    qRegisterMetaType<GitResult>("GitResult");
+
+    // Les commandes en lecture seule ne doivent pas réécrire l'index : cela
+    // réveillerait la surveillance du dépôt (voir RepoWatcher)
+    m_readOnlyEnv = QProcessEnvironment::systemEnvironment();
+    m_readOnlyEnv.insert("GIT_OPTIONAL_LOCKS", "0");
+
+    m_timeouts[Query] = GIT_TIMEOUT_QUERY;
+    m_timeouts[Local] = GIT_TIMEOUT_LOCAL;
+    m_timeouts[Network] = GIT_TIMEOUT_NETWORK;
+}
+
+GitExecutor* GitExecutor::Instance()
+{
+    if(!m_instance)
+        m_instance = new GitExecutor();
+    return m_instance;
+}
+
+/**
+ * @param dir Dossier d'exécution de la commande
+ * @param args Arguments de la commande @b git
+ * @param mode Type d'accès au dépôt de la commande
+ * @return Job associé à la commande
+ *
+ * Ajoute la commande @b git à la file d'attente. Le job renvoyé est détruit
+ * automatiquement après l'émission de son signal GitJob::finished.
+ */
+GitJob* GitExecutor::execute(const QString& dir, const QStringList& args, Mode mode /*= Write*/)
+{
+    GitJob* job = new GitJob(dir, args, mode, this);
+    m_queue.enqueue(job);
+    schedule();
+    return job;
+}
+
+/**
+ * @param dir Dossier d'exécution de la commande
+ * @param args Arguments de la commande @b git
+ * @param mode Type d'accès au dépôt de la commande
+ * @param cap Taille maximale conservée de la sortie standard (octets)
+ * @return Job associé à la commande
+ *
+ * Comme GitExecutor::execute, mais la sortie standard est lue au fil de
+ * l'exécution et transmise par le signal GitJob::outputReady. Seuls les
+ * @c cap premiers octets sont conservés dans GitResult::output.
+ */
+GitJob* GitExecutor::stream(const QString& dir, const QStringList& args, Mode mode /*= Write*/, qint64 cap /*= GIT_STREAM_CAP*/)
+{
+    GitJob* job = new GitJob(dir, args, mode, this);
+    job->m_streamCap = qMax(qint64(0), cap);
+    m_queue.enqueue(job);
+    schedule();
+    return job;
+}
+
+/**
+ * @param dir Dossier d'exécution de la commande
+ * @param args Arguments de la commande @b git, en lecture seule
+ * @param b_optionalLocks Autoriser Git à prendre le verrou optionnel de
+ * l'index pour y enregistrer ses caches (par exemple celui des fichiers non
+ * suivis)
+ * @return Job associé à la commande
+ *
+ * Ajoute une commande en lecture seule à la file de basse priorité : elle ne
+ * sera lancée que lorsqu'aucune commande de la file principale n'attend, sans
+ * occuper le dernier processus disponible (voir GitExecutor::schedule).@n
+ * Une commande d'écriture n'étant jamais exécutée en même temps, le verrou
+ * optionnel ne peut pas faire échouer une autre commande de l'application ;
+ * la réécriture de l'index est en revanche détectée par RepoWatcher.
+ */
+GitJob* GitExecutor::background(const QString& dir, const QStringList& args, bool b_optionalLocks /*= false*/)
+{
+    GitJob* job = new GitJob(dir, args, ReadOnly, this);
+    job->m_bBackground = true;
+    job->m_bOptionalLocks = b_optionalLocks;
+    m_background.enqueue(job);
+    schedule();
+    return job;
+}
+
+/**
+ * Vide les files d'attente et tue les processus en cours. Aucun signal de fin
+ * n'est émis pour les jobs concernés.
+ */
+void GitExecutor::clear()
+{
+    while(!m_queue.isEmpty())
+    {
+        delete m_queue.dequeue();
+    }
+    while(!m_background.isEmpty())
+    {
+        delete m_background.dequeue();
+    }
+    for(GitJob* job : m_running)
+    {
+        job->m_process->disconnect();
+        job->m_process->kill();
+        job->m_process->waitForFinished(1000);
+        delete job;
+    }
+    m_running.clear();
+}
+
+/**
+ * @param n Nombre de processus
+ *
+ * Modifie le nombre maximal de commandes en lecture seule exécutées en
+ * parallèle. Cette valeur est bornée à #GIT_MIN_PARALLEL au minimum, pour
+ * qu'une commande de basse priorité ne retarde jamais la file principale.
+ */
+void GitExecutor::setMaxParallel(int n)
+{
+    m_maxParallel = qMax(GIT_MIN_PARALLEL, n);
+    schedule();
+}
+
+/**
+ * @param job Job à annuler
+ *
+ * Retire le job de la file d'attente ou tue son processus. Les signaux de fin
+ * du job sont émis avec GitResult::canceled. Sans effet sur un job terminé.
+ */
+void GitExecutor::cancel(GitJob* job)
+{
+    if(m_queue.removeOne(job) || m_background.removeOne(job))
+    {
+        qLog->info("GIT | Commande annulée avant son lancement : git", job->m_result.args.join(' '));
+        job->m_result.canceled = true;
+        finish(job);
+    }
+    else if(m_running.contains(job) && !job->m_result.canceled)
+    {
+        qLog->info("GIT | Annulation de la commande : git", job->m_result.args.join(' '));
+        job->m_result.canceled = true;
+        job->m_process->kill();
+    }
+}
+
+/**
+ * @param dir Dossier d'exécution des commandes
+ *
+ * Annule les commandes en lecture seule de la file principale, en attente ou
+ * en cours, lancées dans le dossier @c dir (voir GitExecutor::cancel). Les
+ * commandes d'écriture et de basse priorité ne sont pas concernées.
+ */
+void GitExecutor::cancelQueries(const QString& dir)
+{
+    QList<GitJob*> jobs;
+    for(GitJob* job : m_queue + m_running)
+    {
+        if(job->m_mode == ReadOnly && !job->m_bBackground && job->m_result.workingDirectory == dir)
+            jobs << job;
+    }
+    for(GitJob* job : jobs)
+    {
+        cancel(job);
+    }
+}
+
+/**
+ * @param args Arguments de la commande @b git
+ * @param mode Type d'accès au dépôt de la commande
+ * @return Classe de la commande
+ */
+GitExecutor::CommandClass GitExecutor::commandClass(const QStringList& args, Mode mode)
+{
+    static const QStringList network = QStringList() << "push" << "fetch" << "pull" << "clone" << "ls-remote";
+    if(network.contains(commandName(args)))
+        return Network;
+    return mode == ReadOnly ? Query : Local;
+}
+
+/**
+ * @param args Arguments de la commande @b git
+ * @return Nom de la sous-commande (ex : "status"), après les options
+ * globales comme @c -c @c &lt;clé>=&lt;valeur>
+ */
+QString GitExecutor::commandName(const QStringList& args)
+{
+    for(int i = 0; i < args.length(); i++)
+    {
+        if(args.at(i) == "-c" || args.at(i) == "-C")
+            i++;
+        else if(!args.at(i).startsWith('-'))
+            return args.at(i);
+    }
+    return QString();
+}
+
+/**
+ * @param major Version majeure
+ * @param minor Version mineure
+ * @return @c true si la version de Git installée est au moins
+ * @c major.@c minor, @c false si elle est plus ancienne ou inconnue
+ *
+ * La version est lue une seule fois, par @b git @b --version exécuté hors
+ * file d'attente.
+ */
+bool GitExecutor::versionAtLeast(int major, int minor)
+{
+    if(m_version == -1)
+    {
+        m_version = 0;
+        QProcess process;
+        process.start("git", QStringList() << "--version");
+        if(process.waitForFinished(5000))
+        {
+            // Ex : "git version 2.39.2" ou "git version 2.37.1.windows.1"
+            static const QRegularExpression re("(\\d+)\\.(\\d+)");
+            QRegularExpressionMatch match = re.match(QString::fromUtf8(process.readAllStandardOutput()));
+            if(match.hasMatch())
+                m_version = match.captured(1).toInt() * 1000 + match.captured(2).toInt();
+        }
+        qLog->info("GIT | Version", QString::number(m_version / 1000) + "." + QString::number(m_version % 1000));
+    }
+    return m_version >= major * 1000 + minor;
+}
+
+/**
+ * @param commandClass Classe de commande
+ * @param seconds Délai maximal d'exécution (0 : aucun)
+ *
+ * Modifie le délai au-delà duquel les commandes de cette classe sont tuées.
+ */
+void GitExecutor::setTimeout(CommandClass commandClass, int seconds)
+{
+    m_timeouts[commandClass] = qMax(0, seconds);
+}
+
+/**
+ * Lance les prochaines commandes de la file. L'exclusivité s'applique par
+ * dossier d'exécution : des commandes sur des dépôts différents ne se
+ * bloquent jamais.
+ * @li une commande d'écriture n'est lancée que si aucune commande n'est en
+ * cours dans son dossier
+ * @li les commandes en lecture seule (ou GitExecutor::Concurrent) sont lancées
+ * tant que la limite GitExecutor::m_maxParallel n'est pas atteinte et que les
+ * commandes en cours dans leur dossier sont du même type.
+ *
+ * L'ordre de la file est respecté : une commande ne double jamais la
+ * précédente. Une commande de la file principale bloquée par des commandes de
+ * basse priorité de son dossier les interrompt et les remet en attente (voir
+ * GitExecutor::requeue).@n
+ * Les commandes de basse priorité ne sont lancées que si la file principale
+ * est vide, si les commandes en cours dans leur dossier sont en lecture seule
+ * et dans la limite de GitExecutor::m_maxParallel - 1 processus : il reste
+ * toujours un processus pour la file principale.
+ */
+void GitExecutor::schedule()
+{
+    while(!m_queue.isEmpty())
+    {
+        GitJob* next = m_queue.head();
+        const QString& dir = next->m_result.workingDirectory;
+        bool bBlocked = next->m_mode != Write && m_running.length() >= m_maxParallel;
+        QList<GitJob*> preempted;
+        for(GitJob* job : m_running)
+        {
+            if(job->m_result.workingDirectory != dir || (next->m_mode != Write && job->m_mode == next->m_mode))
+                continue;
+            if(job->m_bBackground)
+                preempted << job;
+            else
+                bBlocked = true;
+        }
+        if(bBlocked)
+            return;
+        for(GitJob* job : preempted)
+        {
+            requeue(job);
+        }
+        start(m_queue.dequeue());
+    }
+
+    int background = 0;
+    for(GitJob* job : m_running)
+    {
+        if(job->m_bBackground)
+            background++;
+    }
+    while(!m_background.isEmpty())
+    {
+        GitJob* next = m_background.head();
+        if(m_running.length() >= m_maxParallel || background >= m_maxParallel - 1)
+            return;
+        for(GitJob* job : m_running)
+        {
+            if(job->m_result.workingDirectory == next->m_result.workingDirectory && job->m_mode != ReadOnly)
+                return;
+        }
+        start(m_background.dequeue());
+        background++;
+    }
+}
+
+/**
+ * @param job Commande de basse priorité en cours
+ *
+ * Interrompt la commande sans émettre ses signaux de fin et la replace en tête
+ * de la file de basse priorité : elle sera relancée depuis le début.
+ */
+void GitExecutor::requeue(GitJob* job)
+{
+    qLog->info("GIT | Commande de basse priorité interrompue : git", job->m_result.args.join(' '));
+    m_running.removeOne(job);
+    job->m_timeout.stop();
+    job->m_timeout.disconnect(job);
+    job->m_process->disconnect(job);
+    job->m_process->kill();
+    job->m_process->deleteLater();
+    job->m_process = nullptr;
+    job->m_result.output.clear();
+    job->m_result.error.clear();
+    job->m_result.outputSize = 0;
+    job->m_result.truncated = false;
+    job->m_errorLine.clear();
+    job->m_clock.start();
+    job->m_traceStart = qTrace->now();
+    m_background.prepend(job);
+}
+
+/**
+ * @param job Job à démarrer
+ *
+ * Crée le processus Git du job et connecte ses signaux de fin.@n
+ * Les phases d'attente (@c git/queue), de lancement du processus
+ * (@c git/spawn), d'exécution (@c git/run) et de lecture des sorties
+ * (@c git/read) sont enregistrées dans le Tracer.@n
+ * Le processus est tué s'il dépasse le délai de sa classe de commande (voir
+ * GitExecutor::setTimeout).
+ */
+void GitExecutor::start(GitJob* job)
+{
+    job->m_result.waited = job->m_clock.restart();
+    const QString command = job->m_result.args.join(' ');
+    qint64 spawnStart = qTrace->now();
+    qTrace->record("git/queue", job->m_traceStart, spawnStart, command);
+    job->m_process = new QProcess(job);
+    job->m_process->setWorkingDirectory(job->m_result.workingDirectory);
+    if(job->m_mode == ReadOnly && !job->m_bOptionalLocks)
+        job->m_process->setProcessEnvironment(m_readOnlyEnv);
+    m_running << job;
+
+    connect(job->m_process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            job, [this, job, command](int exitCode, QProcess::ExitStatus exitStatus) {
+        qint64 readStart = qTrace->now();
+        qTrace->record("git/run", job->m_traceStart, readStart, command);
+        if(job->m_streamCap >= 0)
+        {
+            job->readOutput();
+        }
+        else
+        {
+            job->m_result.output = job->m_process->readAllStandardOutput();
+            job->m_result.outputSize = job->m_result.output.size();
+        }
+        job->readError();
+        job->m_result.error += job->m_errorLine;
+        job->m_errorLine.clear();
+        qTrace->record("git/read", readStart, qTrace->now(), command);
+        job->m_result.exitCode = exitStatus == QProcess::NormalExit ? exitCode : -1;
+        finish(job);
+    });
+    if(job->m_streamCap >= 0)
+    {
+        connect(job->m_process, &QProcess::readyReadStandardOutput, job, [job]() {
+            job->readOutput();
+        });
+    }
+    connect(job->m_process, &QProcess::readyReadStandardError, job, [job]() {
+        job->readError();
+    });
+    connect(job->m_process, &QProcess::errorOccurred, job, [this, job](QProcess::ProcessError error) {
+        if(error == QProcess::FailedToStart)
+        {
+            job->m_result.error = job->m_process->errorString().toUtf8();
+            job->m_result.exitCode = -1;
+            finish(job);
+        }
+    });
+
+    int timeout = m_timeouts[commandClass(job->m_result.args, Mode(job->m_mode))];
+    if(timeout > 0)
+    {
+        job->m_timeout.setSingleShot(true);
+        connect(&job->m_timeout, &QTimer::timeout, job, [job, timeout]() {
+            if(!job->m_process || job->m_result.canceled)
+                return;
+            qLog->warning("GIT | Délai de", timeout, "s dépassé, arrêt de : git", job->m_result.args.join(' '));
+            job->m_result.timedOut = true;
+            job->m_process->kill();
+        });
+        job->m_timeout.start(timeout * 1000);
+    }
+
+    job->m_process->start("git", job->m_result.args);
+    job->m_traceStart = qTrace->now();
+    qTrace->record("git/spawn", spawnStart, job->m_traceStart, command);
+    emit job->started();
+}
+
+/**
+ * @param job Job terminé
+ *
+ * Emet les signaux de fin du job, programme sa destruction puis lance la
+ * commande suivante.
+ */
+void GitExecutor::finish(GitJob* job)
+{
+    job->m_result.elapsed = job->m_clock.elapsed();
+    job->m_timeout.stop();
+    m_running.removeOne(job);
+    if(job->m_process)
+    {
+        job->m_process->disconnect(job);
+        job->m_process->deleteLater();
+        job->m_process = nullptr;
+    }
+    if(job->m_result.canceled)
+    {
+        job->m_result.exitCode = -1;
+        job->m_result.error += "Commande annulée";
+    }
+    else if(job->m_result.timedOut)
+    {
+        job->m_result.exitCode = -1;
+        job->m_result.error += "Délai maximal dépassé (" + QByteArray::number(timeout(commandClass(job->m_result.args, Mode(job->m_mode)))) + " s)";
+    }
+
+    emit jobFinished(job->m_result);
+    emit job->finished(job->m_result);
+    if(job->m_result.success()) emit job->succeeded(job->m_result);
+    else emit job->failed(job->m_result);
+    job->deleteLater();
+
+    schedule();
+}
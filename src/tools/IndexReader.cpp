@@ -0,0 +1,331 @@
+#include "IndexReader.hpp"
+
+#include <cstring>
+
+#define INDEX_HEADER_SIZE   12      /**< Signature, version et nombre d'entrées */
+#define ENTRY_FIXED_SIZE    62      /**< Partie fixe d'une entrée (stat, oid, drapeaux) */
+#define ENTRY_FLAGS_OFFSET  60      /**< Position des drapeaux dans une entrée */
+#define FLAG_EXTENDED       0x4000  /**< Présence des drapeaux étendus */
+#define FLAG_NAME_MASK      0x0FFF  /**< Longueur du nom (0xFFF si 4095 ou plus) */
+
+/**
+ * @param p Données
+ * @return Entier 16 bits gros-boutiste
+ */
+static inline quint16 be16(const uchar* p)
+{
+    return quint16((quint16(p[0]) << 8) | quint16(p[1]));
+}
+
+/**
+ * @param p Données
+ * @return Entier 32 bits gros-boutiste
+ */
+static inline quint32 be32(const uchar* p)
+{
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+}
+
+/**
+ * Contructeur de la classe IndexReader.
+ */
+IndexReader::IndexReader() :
+    m_data(nullptr),
+    m_size(0),
+    m_version(0),
+    m_error(NoError),
+    m_rootTree(-1)
+{
+}
+
+/**
+ * Destructeur de la classe IndexReader.
+ */
+IndexReader::~IndexReader()
+{
+    close();
+}
+
+/**
+ * @param commonDir Dossier Git commun (contient @c config)
+ * @return Format des identifiants d'objet du dépôt (@c sha1, @c sha256...)
+ *
+ * Lit la clé @c extensions.objectformat du fichier @c config du dépôt. Les
+ * fichiers inclus (@c include.path) ne sont pas suivis : Git n'y lit pas les
+ * extensions du dépôt.
+ */
+QString IndexReader::objectFormat(const QString& commonDir)
+{
+    QString format = INDEX_OID_FORMAT;
+    QFile config(commonDir + "/config");
+    if(!config.open(QIODevice::ReadOnly | QIODevice::Text))
+        return format;
+
+    bool bExtensions = false;
+    while(!config.atEnd())
+    {
+        QString line = QString::fromUtf8(config.readLine()).trimmed();
+        if(line.startsWith('['))
+        {
+            // Section, éventuellement suivie d'une clé sur la même ligne
+            int end = line.indexOf(']');
+            bExtensions = line.mid(1, end - 1).trimmed().compare("extensions", Qt::CaseInsensitive) == 0;
+            line = end == -1 ? QString() : line.mid(end + 1).trimmed();
+        }
+        int equal = line.indexOf('=');
+        if(bExtensions && equal != -1 && line.left(equal).trimmed().compare("objectformat", Qt::CaseInsensitive) == 0)
+            format = line.mid(equal + 1).trimmed().toLower();
+    }
+    return format;
+}
+
+/**
+ * @param path Chemin du fichier @c index
+ * @param objectFormat Format des identifiants d'objet du dépôt (voir IndexReader::objectFormat)
+ * @return @c true si le fichier a été lu, voir IndexReader::error sinon
+ *
+ * Projette le fichier en mémoire et analyse ses entrées et extensions. La
+ * somme de contrôle finale n'est pas vérifiée : Git écrit l'index dans un
+ * fichier temporaire avant de le renommer, un index lisible est donc complet.@n
+ * Seuls les identifiants SHA-1 (#INDEX_OID_SIZE octets) sont supportés.
+ */
+bool IndexReader::open(const QString& path, const QString& objectFormat)
+{
+    close();
+    m_file.setFileName(path);
+    if(objectFormat != INDEX_OID_FORMAT)
+        return fail(Unsupported, "Format d'objet " + objectFormat + " non supporté");
+    if(!m_file.open(QIODevice::ReadOnly))
+        return fail(OpenError, m_file.errorString());
+
+    m_size = m_file.size();
+    if(m_size < INDEX_HEADER_SIZE + INDEX_OID_SIZE)
+        return fail(FormatError, "Fichier trop court");
+    m_data = m_file.map(0, m_size);
+    if(!m_data)
+        return fail(OpenError, m_file.errorString());
+
+    if(std::memcmp(m_data, "DIRC", 4) != 0)
+        return fail(FormatError, "Signature invalide");
+    m_version = int(be32(m_data + 4));
+    if(m_version < 2 || m_version > 4)
+        return fail(Unsupported, "Version " + QString::number(m_version) + " non supportée");
+    quint32 count = be32(m_data + 8);
+    if(count > quint32(m_size / ENTRY_FIXED_SIZE))
+        return fail(FormatError, "Nombre d'entrées invalide");
+
+    qint64 pos = INDEX_HEADER_SIZE;
+    if(!parseEntries(int(count), pos))
+        return false;
+    return parseExtensions(pos);
+}
+
+/**
+ * Libère la projection et ferme le fichier. Les entrées ne sont plus valides.
+ */
+void IndexReader::close()
+{
+    if(m_data)
+    {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    if(m_file.isOpen())
+        m_file.close();
+    m_size = 0;
+    m_version = 0;
+    m_error = NoError;
+    m_errorString.clear();
+    m_entries.clear();
+    m_paths.clear();
+    m_extensions.clear();
+    m_rootTree = -1;
+}
+
+/**
+ * @return Somme de contrôle du fichier (identifiant de son contenu)
+ */
+QByteArray IndexReader::checksum() const
+{
+    if(!m_data)
+        return QByteArray();
+    return QByteArray(reinterpret_cast<const char*>(m_data + m_size - INDEX_OID_SIZE), INDEX_OID_SIZE);
+}
+
+/**
+ * @return Arbre racine en cache (extension @c TREE, hexadécimal), vide s'il
+ * est absent ou invalidé
+ */
+QByteArray IndexReader::rootTree() const
+{
+    if(!m_data || m_rootTree < 0)
+        return QByteArray();
+    return QByteArray(reinterpret_cast<const char*>(m_data + m_rootTree), INDEX_OID_SIZE).toHex();
+}
+
+/**
+ * @param error Erreur
+ * @param message Description de l'erreur
+ * @return @c false
+ */
+bool IndexReader::fail(Error error, const QString& message)
+{
+    QString path = m_file.fileName();
+    close();
+    m_error = error;
+    m_errorString = path + " : " + message;
+    return false;
+}
+
+/**
+ * @param count Nombre d'entrées
+ * @param pos Position de la première entrée, mise à jour avec la position
+ * suivant la dernière entrée
+ * @return @c true si les entrées sont valides
+ *
+ * En version 4, chaque chemin est codé par le nombre d'octets à retirer à la
+ * fin du chemin précédent suivi du suffixe à ajouter : les chemins sont alors
+ * reconstruits dans un tampon unique.
+ */
+bool IndexReader::parseEntries(int count, qint64& pos)
+{
+    const qint64 end = m_size - INDEX_OID_SIZE;
+    const bool bPrefix = m_version == 4;
+    QVector<int> offsets;
+    QByteArray previous;
+    if(bPrefix)
+        offsets.reserve(count);
+    m_entries.reserve(count);
+
+    for(int i = 0; i < count; i++)
+    {
+        if(pos + ENTRY_FIXED_SIZE > end)
+            return fail(FormatError, "Entrée tronquée");
+        IndexEntry entry;
+        entry.record = m_data + pos;
+        entry.flags = be16(entry.record + ENTRY_FLAGS_OFFSET);
+        entry.extended = 0;
+        qint64 pathPos = pos + ENTRY_FIXED_SIZE;
+        if(entry.flags & FLAG_EXTENDED)
+        {
+            if(m_version < 3)
+                return fail(FormatError, "Drapeaux étendus en version 2");
+            if(pathPos + 2 > end)
+                return fail(FormatError, "Entrée tronquée");
+            entry.extended = be16(m_data + pathPos);
+            pathPos += 2;
+        }
+
+        if(!bPrefix)
+        {
+            int length = entry.flags & FLAG_NAME_MASK;
+            if(length == FLAG_NAME_MASK)
+            {
+                const void* nul = std::memchr(m_data + pathPos, '\0', size_t(end - pathPos));
+                if(!nul)
+                    return fail(FormatError, "Chemin non terminé");
+                length = int(static_cast<const uchar*>(nul) - (m_data + pathPos));
+            }
+            // Entrée complétée de 1 à 8 caractères nuls jusqu'à un multiple de 8
+            qint64 next = pos + (((pathPos - pos) + length + 8) & ~qint64(7));
+            if(next > end || m_data[pathPos + length] != '\0')
+                return fail(FormatError, "Entrée invalide");
+            entry.path = reinterpret_cast<const char*>(m_data + pathPos);
+            entry.pathLength = length;
+            pos = next;
+        }
+        else
+        {
+            // Entier à longueur variable : nombre d'octets à retirer
+            quint64 strip = 0;
+            uchar c;
+            do
+            {
+                if(pathPos >= end)
+                    return fail(FormatError, "Entrée tronquée");
+                c = m_data[pathPos++];
+                strip = (strip << 7) | (c & 0x7F);
+                if(c & 0x80)
+                    strip++;
+                if(strip > quint64(end))
+                    return fail(FormatError, "Préfixe invalide");
+            } while(c & 0x80);
+            if(strip > quint64(previous.length()))
+                return fail(FormatError, "Préfixe invalide");
+
+            const void* nul = std::memchr(m_data + pathPos, '\0', size_t(end - pathPos));
+            if(!nul)
+                return fail(FormatError, "Chemin non terminé");
+            int suffix = int(static_cast<const uchar*>(nul) - (m_data + pathPos));
+            previous.truncate(previous.length() - int(strip));
+            previous.append(reinterpret_cast<const char*>(m_data + pathPos), suffix);
+
+            offsets.append(m_paths.length());
+            m_paths.append(previous);
+            entry.path = nullptr;
+            entry.pathLength = previous.length();
+            pos = pathPos + suffix + 1;
+        }
+        m_entries.append(entry);
+    }
+
+    // Le tampon des chemins est complet : les pointeurs restent valides
+    if(bPrefix)
+    {
+        const char* base = m_paths.constData();
+        for(int i = 0; i < m_entries.length(); i++)
+        {
+            m_entries[i].path = base + offsets.at(i);
+        }
+    }
+    return true;
+}
+
+/**
+ * @param pos Position de la première extension
+ * @return @c true si les extensions sont valides et supportées
+ */
+bool IndexReader::parseExtensions(qint64 pos)
+{
+    const qint64 end = m_size - INDEX_OID_SIZE;
+    while(pos + 8 <= end)
+    {
+        const uchar* header = m_data + pos;
+        QString signature = QString::fromLatin1(reinterpret_cast<const char*>(header), 4);
+        quint32 size = be32(header + 4);
+        if(qint64(size) > end - pos - 8)
+            return fail(FormatError, "Extension " + signature + " tronquée");
+        if(signature == "link")
+            return fail(Unsupported, "Index partagé (split index) non supporté");
+        if(signature == "sdir")
+            return fail(Unsupported, "Index creux (sparse index) non supporté");
+        if(signature == "TREE")
+            parseTree(header + 8, size);
+        m_extensions << signature;
+        pos += 8 + size;
+    }
+    if(pos != end)
+        return fail(FormatError, "Données inattendues après les extensions");
+    return true;
+}
+
+/**
+ * @param data Données de l'extension @c TREE
+ * @param size Taille des données
+ *
+ * Seule la première entrée (arbre racine, chemin vide) est lue : elle a la
+ * forme @c "\0<entrées> <sous-arbres>\n<oid>". Un nombre d'entrées négatif
+ * indique un arbre invalidé.
+ */
+void IndexReader::parseTree(const uchar* data, quint32 size)
+{
+    m_rootTree = -1;
+    if(size == 0 || data[0] != '\0')
+        return;
+    const void* eol = std::memchr(data, '\n', size);
+    if(!eol || data[1] == '-')
+        return;
+    qint64 oid = static_cast<const uchar*>(eol) + 1 - m_data;
+    if(oid + INDEX_OID_SIZE <= (data - m_data) + qint64(size))
+        m_rootTree = oid;
+}
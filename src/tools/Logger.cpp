@@ -1,25 +1,70 @@
 #include "Logger.hpp"
 
-#include <QDateTime>
 #include <QDebug>
+#include <QFileInfo>
 
-#define LOG_CODEC "UTF-16"
+#define LOG_CODEC       "UTF-8"
+#define LOG_RING_MASK   (LOG_RING_SIZE - 1)
+#define LOG_FLUSH_MS    100     /**< Délai maximal entre deux écritures par lot */
 
-Logger* Logger::m_instance = nullptr;
+/**
+ * @struct KeywordFilter
+ * @brief Niveau minimal imposé par les mots clés du thread courant.
+ */
+struct KeywordFilter
+{
+    int generation = -1;/**< Génération des filtres utilisée pour le calcul (-1 : à recalculer) */
+    int level = 0;/**< Niveau minimal */
+};
+
+static thread_local QStringList t_keywords;/**< Mots clés du thread courant */
+static thread_local KeywordFilter t_filter;/**< Cache du filtre par mot clé du thread courant */
 
-Logger::Logger()
+Logger::Logger() :
+    m_tail(0),
+    m_reported(0),
+    m_writer(nullptr),
+    m_format(Text),
+    m_maxBytes(0),
+    m_maxAge(0),
+    m_retention(0)
 {
-    reset();
+    for(quint32 i = 0; i < LOG_RING_SIZE; i++)
+    {
+        m_ring[i].sequence.store(i);
+    }
+    // Les messages antérieurs au premier Logger::createLog (lecture du fichier
+    // INI) attendent dans le tampon l'ouverture du fichier
+    m_bOpen.store(1);
 }
 
 Logger* Logger::Instance()
 {
-    if(!m_instance)
-        m_instance = new Logger();
-    return m_instance;
+    // Initialisation garantie unique même si plusieurs threads l'appellent
+    static Logger* instance = new Logger();
+    return instance;
+}
+
+/**
+ * @param maxBytes Taille maximale du fichier en octets (0 : illimitée)
+ * @param maxAge Age maximal du fichier en secondes (0 : illimité)
+ * @param retention Nombre d'anciens fichiers conservés
+ *
+ * Configure la rotation du journal. Doit être appelée avant Logger::createLog.
+ */
+void Logger::setRotation(qint64 maxBytes, int maxAge, int retention)
+{
+    m_maxBytes = qMax(qint64(0), maxBytes);
+    m_maxAge = qMax(0, maxAge);
+    m_retention = qMax(0, retention);
 }
 
-void Logger::createLog(const QString& fileName, bool overwrite)
+/**
+ * @param fileName Fichier du journal
+ * @param overwrite Remplace le fichier existant au lieu d'écrire à sa suite
+ * @param format Format du fichier
+ */
+void Logger::createLog(const QString& fileName, bool overwrite, Format format)
 {
     if(m_logFile.isOpen())
     {
@@ -27,84 +72,384 @@ void Logger::createLog(const QString& fileName, bool overwrite)
     }
 
     m_logFile.setFileName(fileName);
+    m_format = format;
+    if(!overwrite && m_logFile.exists())
+    {
+        // Un fichier trop ancien, trop gros ou d'un autre format est archivé :
+        // en texte, un journal binaire ou un ancien journal UTF-16 (BOM FF FE
+        // ou FE FF) ne peut pas être complété en UTF-8
+        bool bRotate = false;
+        if(m_logFile.size() > 0 && m_logFile.open(QIODevice::ReadOnly))
+        {
+            QByteArray header = m_logFile.read(4);
+            m_logFile.close();
+            if(format == Binary)
+                bRotate = header != LOG_BINARY_MAGIC;
+            else
+                bRotate = header == LOG_BINARY_MAGIC || header.startsWith("\xFF\xFE") || header.startsWith("\xFE\xFF");
+        }
+        QFileInfo info(m_logFile);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+        m_created = info.birthTime().isValid() ? info.birthTime() : info.lastModified();
+#else
+        m_created = info.created();
+#endif
+        if(bRotate || needsRotation())
+            rotateFiles();
+    }
+    if(openFile(overwrite))
+    {
+        m_bStop.store(0);
+        m_writer = new Writer(this);
+        m_writer->start(QThread::LowPriority);
+        m_bOpen.store(1);
+    }
+    else
+    {
+        m_bOpen.store(0);
+    }
+}
+
+/**
+ * Ferme le journal. Le thread d'écriture écrit tous les messages en attente
+ * avant de s'arrêter.
+ */
+void Logger::close()
+{
+    m_bOpen.store(0);
+    if(m_writer)
+    {
+        m_wakeMutex.lock();
+        m_bStop.store(1);
+        m_wake.wakeOne();
+        m_wakeMutex.unlock();
+        m_writer->wait();
+        delete m_writer;
+        m_writer = nullptr;
+    }
+    if(m_logFile.isOpen())
+    {
+        // Messages déposés pendant l'arrêt du thread d'écriture
+        drain();
+        flush();
+        m_logStream.setDevice(nullptr);
+        m_binaryStream.setDevice(nullptr);
+        m_logFile.close();
+    }
+}
+
+/**
+ * @param overwrite Remplace le fichier existant au lieu d'écrire à sa suite
+ * @return @c true si le fichier est ouvert
+ *
+ * Ouvre le fichier du journal et écrit l'en-tête d'un nouveau fichier binaire.
+ */
+bool Logger::openFile(bool overwrite)
+{
     QFile::OpenMode openMode = QIODevice::WriteOnly;
-    if(overwrite)
+    openMode |= overwrite ? QIODevice::Truncate : QIODevice::Append;
+    if(!m_logFile.open(openMode))
+        return false;
+
+    if(m_logFile.size() == 0)
+        m_created = QDateTime::currentDateTime();
+    if(m_format == Binary)
     {
-        openMode |= QIODevice::Truncate;
+        m_binaryStream.setDevice(&m_logFile);
+        m_binaryStream.setVersion(QDataStream::Qt_5_0);
+        if(m_logFile.size() == 0)
+        {
+            m_binaryStream.writeRawData(LOG_BINARY_MAGIC, 4);
+            m_binaryStream << quint8(LOG_BINARY_VERSION);
+        }
     }
-    if(m_logFile.open(openMode))
+    else
     {
         m_logStream.setDevice(&m_logFile);
         m_logStream.setCodec(LOG_CODEC);
     }
+    return true;
 }
 
-void Logger::close()
+/**
+ * @return @c true si le fichier dépasse la taille ou l'âge maximal
+ */
+bool Logger::needsRotation() const
+{
+    return (m_maxBytes > 0 && m_logFile.size() >= m_maxBytes) ||
+           (m_maxAge > 0 && m_created.secsTo(QDateTime::currentDateTime()) >= m_maxAge);
+}
+
+/**
+ * Archive le fichier courant et en ouvre un nouveau. Appelée par le thread
+ * d'écriture entre deux lots.
+ */
+void Logger::rotate()
 {
+    flush();
+    m_logStream.setDevice(nullptr);
+    m_binaryStream.setDevice(nullptr);
     m_logFile.close();
+    rotateFiles();
+    openFile(true);
+}
+
+/**
+ * Décale les anciens fichiers (@c journal.1 devient @c journal.2, ...), le plus
+ * ancien au-delà de la rétention étant supprimé, puis renomme le fichier
+ * courant en @c journal.1. Le fichier doit être fermé.
+ */
+void Logger::rotateFiles()
+{
+    const QString fileName = m_logFile.fileName();
+    if(m_retention == 0)
+    {
+        QFile::remove(fileName);
+        return;
+    }
+    QFile::remove(fileName + '.' + QString::number(m_retention));
+    for(int i = m_retention - 1; i >= 1; i--)
+    {
+        QFile::rename(fileName + '.' + QString::number(i), fileName + '.' + QString::number(i + 1));
+    }
+    QFile::rename(fileName, fileName + ".1");
+}
+
+/**
+ * Vide les tampons d'écriture vers le fichier.
+ */
+void Logger::flush()
+{
+    if(m_format == Binary)
+        m_logFile.flush();
+    else
+        m_logStream.flush();
 }
 
 void Logger::addKeyWord(const QString& kw)
 {
-    m_kw << kw;
+    t_keywords << kw;
+    t_filter.generation = -1;
 }
 
 void Logger::removeKeyWord()
 {
-    m_kw.removeLast();
+    if(!t_keywords.isEmpty())
+        t_keywords.removeLast();
+    t_filter.generation = -1;
 }
 
-void Logger::reset()
+/**
+ * @param kw Mot clé
+ * @param lvl Niveau minimal des messages écrits tant que @c kw est dans la pile
+ * des mots clés du thread
+ */
+void Logger::setKeywordLevel(const QString& kw, LogLevel lvl)
 {
-    m_buffer.setString(&m_output, QIODevice::WriteOnly | QIODevice::Truncate);
-    m_buffer.setCodec(LOG_CODEC);
-    m_output = "";
+    QMutexLocker lock(&m_filterMutex);
+    m_keywordLevels.insert(kw, lvl);
+    m_keywordFilters.store(m_keywordLevels.size());
+    m_filterGeneration.ref();
 }
 
-void Logger::printInfo(LogLevel lvl)
+/**
+ * Supprime tous les filtres par mot clé.
+ */
+void Logger::clearKeywordLevels()
 {
-    if(m_logFile.isOpen())
+    QMutexLocker lock(&m_filterMutex);
+    m_keywordLevels.clear();
+    m_keywordFilters.store(0);
+    m_filterGeneration.ref();
+}
+
+/**
+ * @param lvl Niveau du message
+ * @return @c true si aucun mot clé du thread n'impose un niveau supérieur
+ *
+ * Le niveau imposé par les mots clés est mis en cache pour chaque thread et
+ * n'est recalculé que si la pile des mots clés ou les filtres ont changé.
+ */
+bool Logger::keywordAllows(LogLevel lvl) const
+{
+    if(t_keywords.isEmpty())
+        return true;
+    int generation = m_filterGeneration.load();
+    if(t_filter.generation != generation)
     {
-        // Info log
-        QDateTime datetime = QDateTime::currentDateTime();
-        QString datetimeStr = datetime.toString("yyyy-MM-dd HH:mm:ss.zzz | ");
-        QString errStr;
-        switch(lvl)
+        QMutexLocker lock(&m_filterMutex);
+        int level = 0;
+        for(const QString& kw : t_keywords)
         {
-            case Debug:
-                errStr = "DBG | ";
-                qDebug() << m_output;
-                break;
-            case Info:
-                errStr = "INF | ";
-                qInfo() << m_output;
-                break;
-            case Warning:
-                errStr = "WRN | ";
-                qWarning() << m_output;
-                break;
-            case Error:
-                errStr = "ERR | ";
-                qCritical() << m_output;
-                break;
-            case Fatal:
-                errStr = "FTL | ";
-                qCritical() << m_output.toStdString().c_str();
+            level = qMax(level, m_keywordLevels.value(kw, 0));
+        }
+        t_filter.level = level;
+        t_filter.generation = generation;
+    }
+    return lvl >= t_filter.level;
+}
+
+/**
+ * @param lvl Niveau du message
+ * @param message Message formaté
+ *
+ * Dépose le message dans le tampon circulaire sans verrou. Chaque producteur
+ * réserve une case en incrémentant la position d'écriture, la remplit puis la
+ * publie en mettant à jour son numéro de tour. Si le tampon est plein, le
+ * message est compté comme perdu.
+ */
+void Logger::push(LogLevel lvl, const QString& message)
+{
+    quint32 pos = m_head.loadAcquire();
+    Record* record;
+    for(;;)
+    {
+        record = &m_ring[pos & LOG_RING_MASK];
+        qint32 diff = qint32(record->sequence.loadAcquire() - pos);
+        if(diff == 0)
+        {
+            if(m_head.testAndSetRelaxed(pos, pos + 1, pos))
                 break;
         }
-        QString kw = m_kw.join(" - ");
-        if(kw != "")
-            kw += " - ";
+        else if(diff < 0)
+        {
+            m_dropped.ref();
+            return;
+        }
+        else
+        {
+            pos = m_head.loadAcquire();
+        }
+    }
 
-        QStringList lines = m_output.split('\n');
-        // Write
-        for(const QString& str: lines)
+    record->time = QDateTime::currentMSecsSinceEpoch();
+    record->level = lvl;
+    record->keywords = t_keywords.isEmpty() ? QString() : t_keywords.join(" - ") + " - ";
+    record->text = message;
+    record->sequence.storeRelease(pos + 1);
+
+    // Les erreurs sont écrites sans attendre le prochain lot
+    if(lvl >= Error)
+        m_wake.wakeOne();
+}
+
+/**
+ * Boucle du thread d'écriture : vide le tampon par lots et écrit le fichier
+ * une fois par lot, au plus tard toutes les #LOG_FLUSH_MS millisecondes.
+ */
+void Logger::writerLoop()
+{
+    for(;;)
+    {
+        if(drain() > 0)
+        {
+            flush();
+            if(needsRotation())
+                rotate();
+        }
+
+        m_wakeMutex.lock();
+        bool bStop = m_bStop.load();
+        if(!bStop)
+            m_wake.wait(&m_wakeMutex, LOG_FLUSH_MS);
+        m_wakeMutex.unlock();
+        if(bStop)
+            break;
+    }
+    if(drain() > 0)
+        flush();
+}
+
+/**
+ * @return Nombre de messages écrits
+ *
+ * Ecrit tous les messages publiés et libère leurs cases. Le nombre de messages
+ * perdus depuis le dernier appel est ajouté au journal.
+ */
+int Logger::drain()
+{
+    int count = 0;
+    for(;;)
+    {
+        Record& record = m_ring[m_tail & LOG_RING_MASK];
+        if(qint32(record.sequence.loadAcquire() - (m_tail + 1)) < 0)
+            break;
+        write(record);
+        record.keywords.clear();
+        record.text.clear();
+        record.sequence.storeRelease(m_tail + LOG_RING_SIZE);
+        m_tail++;
+        count++;
+    }
+
+    int dropped = m_dropped.load();
+    if(dropped != m_reported)
+    {
+        Record report;
+        report.time = QDateTime::currentMSecsSinceEpoch();
+        report.level = Warning;
+        report.text = "Journal saturé : " + QString::number(dropped - m_reported) + " messages perdus";
+        write(report);
+        m_reported = dropped;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @param record Message à écrire
+ *
+ * Ecrit le message dans le fichier, une ligne par ligne du message au format
+ * texte ou un enregistrement au format binaire, et le transmet aux messages de
+ * Qt.
+ */
+void Logger::write(const Record& record)
+{
+    QString errStr;
+    switch(record.level)
+    {
+        case Debug:
+            errStr = "DBG | ";
+            qDebug() << record.text;
+            break;
+        case Info:
+            errStr = "INF | ";
+            qInfo() << record.text;
+            break;
+        case Warning:
+            errStr = "WRN | ";
+            qWarning() << record.text;
+            break;
+        case Error:
+            errStr = "ERR | ";
+            qCritical() << record.text;
+            break;
+        case Fatal:
+            errStr = "FTL | ";
+            qCritical() << record.text.toStdString().c_str();
+            break;
+    }
+
+    if(m_format == Binary)
+    {
+        QByteArray keywords = record.keywords.toUtf8().left(0xFFFF);
+        QByteArray text = record.text.toUtf8();
+        m_binaryStream << qint64(record.time) << quint8(record.level)
+                       << quint16(keywords.size()) << quint32(text.size());
+        m_binaryStream.writeRawData(keywords.constData(), keywords.size());
+        m_binaryStream.writeRawData(text.constData(), text.size());
+        return;
+    }
+
+    QString datetimeStr = QDateTime::fromMSecsSinceEpoch(record.time).toString("yyyy-MM-dd HH:mm:ss.zzz | ");
+    QStringList lines = record.text.split('\n');
+    // Write
+    for(const QString& str: lines)
+    {
+        if(str.trimmed() != "")
         {
-            if(str.trimmed() != "")
-            {
-                m_logStream << datetimeStr << errStr << kw << str.trimmed() << endl;
-                errStr = "    | "; // Reset du mot clé d'erreur pour une meilleure lecture des logs
-            }
+            m_logStream << datetimeStr << errStr << record.keywords << str.trimmed() << '\n';
+            errStr = "    | "; // Reset du mot clé d'erreur pour une meilleure lecture des logs
         }
     }
 }
@@ -0,0 +1,331 @@
+#include "RefReader.hpp"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstring>
+
+#include "RepoWatcher.hpp"
+
+#define SYMREF_PREFIX   "ref: "         /**< Début d'une référence symbolique */
+#define HEADS_PREFIX    "refs/heads/"   /**< Début du nom complet d'une branche locale */
+
+/**
+ * Contructeur de la classe RefReader.
+ */
+RefReader::RefReader() :
+    m_bValid(false),
+    m_bCached(false)
+{
+}
+
+/**
+ * @param gitDir Dossier Git du dépôt (contient @c HEAD)
+ * @param commonDir Dossier Git commun (contient @c refs, @c packed-refs et
+ * @c config)
+ *
+ * Change le dépôt et vide le cache.
+ */
+void RefReader::setRepository(const QString& gitDir, const QString& commonDir)
+{
+    m_gitDir = gitDir;
+    m_commonDir = commonDir.isEmpty() ? gitDir : commonDir;
+    m_stamp.setRepository(m_gitDir, m_commonDir);
+    clear();
+}
+
+/**
+ * Vide le cache : la prochaine lecture relira tous les fichiers.
+ */
+void RefReader::clear()
+{
+    m_stamp.reset();
+    m_configStamp = QDateTime();
+    m_remotes.clear();
+    m_upstreams.clear();
+    m_snapshot.clear();
+    m_bValid = false;
+    m_bCached = false;
+}
+
+/**
+ * @return @c false si le dépôt utilise le stockage @c reftable
+ */
+bool RefReader::isSupported() const
+{
+    return !m_gitDir.isEmpty() && !QFileInfo::exists(m_commonDir + "/reftable");
+}
+
+/**
+ * @param snapshot Références lues
+ * @return @c true si la lecture a réussi
+ *
+ * Si ni les références ni le fichier @c config n'ont changé depuis la
+ * dernière lecture, le résultat précédent est renvoyé sans lire les fichiers
+ * de références.
+ */
+bool RefReader::read(RefSnapshot& snapshot)
+{
+    m_bCached = false;
+    if(!isSupported())
+        return false;
+
+    QDateTime configStamp = m_configStamp;
+    readConfig();
+    bool bConfigChanged = configStamp != m_configStamp;
+    int changes = m_stamp.update();
+    if(m_bValid && !bConfigChanged && !(changes & RepoWatcher::RefsChange))
+    {
+        snapshot = m_snapshot;
+        m_bCached = true;
+        return true;
+    }
+
+    QVector<RefRecord> records;
+    QHash<QString, int> names;
+    if(!readPacked(records, names))
+    {
+        clear();
+        return false;
+    }
+    readLoose(records, names);
+    std::sort(records.begin(), records.end(), [](const RefRecord& a, const RefRecord& b) {
+        return a.refname < b.refname;
+    });
+
+    QString head = readHead();
+    for(RefRecord& record : records)
+    {
+        if(record.type == RefRecord::Branch)
+        {
+            record.head = record.refname == head;
+            record.upstream = m_upstreams.value(record.name);
+        }
+    }
+
+    m_snapshot.clear();
+    m_snapshot.records() = records;
+    for(const QString& remote : m_remotes)
+    {
+        m_snapshot.addRemote(remote);
+    }
+    m_bValid = true;
+    snapshot = m_snapshot;
+    return true;
+}
+
+/**
+ * @return Dépôts distants déclarés dans le fichier @c config du dépôt
+ */
+QStringList RefReader::configRemotes()
+{
+    readConfig();
+    return m_remotes;
+}
+
+/**
+ * Lit les sections @c [remote "nom"] et @c [branch "nom"] du fichier
+ * @c config si sa date de modification a changé. La branche amont est déduite
+ * de @c branch.<nom>.remote et @c branch.<nom>.merge avec la correspondance
+ * par défaut des dépôts distants (@c refs/remotes/<distant>/<branche>).
+ */
+void RefReader::readConfig()
+{
+    QFileInfo info(m_commonDir + "/config");
+    QDateTime stamp = info.exists() ? info.lastModified() : QDateTime();
+    if(stamp == m_configStamp && !m_configStamp.isNull())
+        return;
+    m_configStamp = stamp;
+    m_remotes.clear();
+    m_upstreams.clear();
+
+    QFile file(info.filePath());
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+    QString section;
+    QString subsection;
+    QHash<QString, QString> remotes;
+    QHash<QString, QString> merges;
+    while(!file.atEnd())
+    {
+        QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if(line.isEmpty() || line.startsWith('#') || line.startsWith(';'))
+            continue;
+        if(line.startsWith('['))
+        {
+            int end = line.indexOf(']');
+            QString header = line.mid(1, end - 1).trimmed();
+            int quote = header.indexOf('"');
+            section = (quote == -1 ? header : header.left(quote)).trimmed().toLower();
+            subsection = quote == -1 ? QString() : header.mid(quote + 1, header.lastIndexOf('"') - quote - 1);
+            if(section == "remote" && !subsection.isEmpty() && !m_remotes.contains(subsection))
+                m_remotes << subsection;
+            continue;
+        }
+        if(section != "branch" || subsection.isEmpty())
+            continue;
+        int equal = line.indexOf('=');
+        if(equal == -1)
+            continue;
+        QString key = line.left(equal).trimmed().toLower();
+        QString value = line.mid(equal + 1).trimmed();
+        if(value.length() >= 2 && value.startsWith('"') && value.endsWith('"'))
+            value = value.mid(1, value.length() - 2);
+        if(key == "remote") remotes.insert(subsection, value);
+        else if(key == "merge") merges.insert(subsection, value);
+    }
+    file.close();
+
+    for(auto it = merges.constBegin(); it != merges.constEnd(); ++it)
+    {
+        QString remote = remotes.value(it.key());
+        if(remote.isEmpty())
+            continue;
+        QString merge = it.value();
+        if(remote == ".")
+            m_upstreams.insert(it.key(), merge);
+        else if(merge.startsWith(HEADS_PREFIX))
+            m_upstreams.insert(it.key(), "refs/remotes/" + remote + '/' + merge.mid(int(strlen(HEADS_PREFIX))));
+    }
+}
+
+/**
+ * @param records Références, complétées par cette fonction
+ * @param names Position de chaque référence dans @c records
+ * @return @c false si le fichier existe mais n'a pas pu être lu
+ *
+ * Le fichier @c packed-refs est projeté en mémoire. Chaque ligne contient
+ * l'objet et le nom d'une référence ; une ligne commençant par @c ^ donne le
+ * commit pointé par le tag annoté de la ligne précédente.
+ */
+bool RefReader::readPacked(QVector<RefRecord>& records, QHash<QString, int>& names) const
+{
+    QFile file(m_commonDir + "/packed-refs");
+    if(!file.exists())
+        return true;
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    const qint64 size = file.size();
+    if(size == 0)
+        return true;
+    const uchar* map = file.map(0, size);
+    if(!map)
+        return false;
+
+    const char* data = reinterpret_cast<const char*>(map);
+    qint64 pos = 0;
+    while(pos < size)
+    {
+        const char* found = static_cast<const char*>(std::memchr(data + pos, '\n', size_t(size - pos)));
+        qint64 end = found ? found - data : size;
+        const char* line = data + pos;
+        int length = int(end - pos);
+        if(length > 0 && line[length - 1] == '\r')
+            length--;
+
+        if(length > 1 && line[0] == '^')
+        {
+            if(!records.isEmpty())
+                records.last().peeled = QByteArray(line + 1, length - 1);
+        }
+        else if(length > 0 && line[0] != '#')
+        {
+            const char* space = static_cast<const char*>(std::memchr(line, ' ', size_t(length)));
+            if(space)
+            {
+                RefRecord record;
+                RefSnapshot::setRefname(record, QString::fromUtf8(space + 1, int(line + length - space - 1)));
+                record.oid = QByteArray(line, int(space - line));
+                names.insert(record.refname, records.length());
+                records.append(record);
+            }
+        }
+        pos = end + 1;
+    }
+    file.unmap(const_cast<uchar*>(map));
+    file.close();
+    return true;
+}
+
+/**
+ * @param records Références, complétées ou remplacées par cette fonction
+ * @param names Position de chaque référence dans @c records
+ *
+ * Parcourt les fichiers de @c refs. Un fichier individuel remplace l'entrée de
+ * même nom de @c packed-refs. Les références symboliques (par exemple
+ * @c refs/remotes/origin/HEAD) prennent l'objet de leur cible.
+ */
+void RefReader::readLoose(QVector<RefRecord>& records, QHash<QString, int>& names) const
+{
+    const QString refsDir = m_commonDir + "/refs";
+    QHash<int, QString> symrefs;
+    QDirIterator it(refsDir, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while(it.hasNext())
+    {
+        QString path = it.next();
+        if(path.endsWith(".lock"))
+            continue;
+        QFile file(path);
+        if(!file.open(QIODevice::ReadOnly))
+            continue;
+        QByteArray content = file.readAll().trimmed();
+        file.close();
+        if(content.isEmpty())
+            continue;
+
+        QString refname = "refs" + path.mid(refsDir.length());
+        int idx = names.value(refname, -1);
+        if(idx == -1)
+        {
+            idx = records.length();
+            records.append(RefRecord());
+            RefSnapshot::setRefname(records.last(), refname);
+            names.insert(refname, idx);
+        }
+        RefRecord& record = records[idx];
+        record.peeled.clear();
+        if(content.startsWith(SYMREF_PREFIX))
+        {
+            record.oid.clear();
+            symrefs.insert(idx, QString::fromUtf8(content.mid(int(strlen(SYMREF_PREFIX)))));
+        }
+        else
+        {
+            record.oid = content;
+        }
+    }
+
+    // Résolution des références symboliques, les cibles introuvables sont retirées
+    QVector<int> broken;
+    for(auto sym = symrefs.constBegin(); sym != symrefs.constEnd(); ++sym)
+    {
+        int target = names.value(sym.value(), -1);
+        if(target != -1 && !records.at(target).oid.isEmpty())
+            records[sym.key()].oid = records.at(target).oid;
+        else
+            broken << sym.key();
+    }
+    std::sort(broken.begin(), broken.end());
+    for(int i = broken.length() - 1; i >= 0; i--)
+    {
+        records.remove(broken.at(i));
+    }
+}
+
+/**
+ * @return Nom complet de la branche pointée par HEAD, vide si HEAD est
+ * détachée
+ */
+QString RefReader::readHead() const
+{
+    QFile file(m_gitDir + "/HEAD");
+    if(!file.open(QIODevice::ReadOnly))
+        return QString();
+    QByteArray content = file.readAll().trimmed();
+    file.close();
+    if(!content.startsWith(SYMREF_PREFIX))
+        return QString();
+    return QString::fromUtf8(content.mid(int(strlen(SYMREF_PREFIX))));
+}
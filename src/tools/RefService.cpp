@@ -0,0 +1,68 @@
+#include "RefService.hpp"
+
+#include "Logger.hpp"
+
+/**
+ * @param parent Objet parent
+ *
+ * Contructeur de la classe RefService.
+ */
+RefService::RefService(QObject* parent) :
+    QObject(parent),
+    m_bTracking(false)
+{
+}
+
+/**
+ * @param workDir Dossier d'exécution des commandes
+ * @param gitDir Dossier Git du dépôt
+ * @param commonDir Dossier Git commun
+ *
+ * Change le dépôt et efface la liste des références.
+ */
+void RefService::setRepository(const QString& workDir, const QString& gitDir, const QString& commonDir)
+{
+    m_workDir = workDir;
+    m_reader.setRepository(gitDir, commonDir);
+    m_snapshot.clear();
+}
+
+/**
+ * @return Job de la commande lancée, @c nullptr si les références ont été lues
+ * sans processus
+ *
+ * Lit les références grâce à RefReader et émet immédiatement le signal
+ * RefService::updated. En cas d'échec, lance la commande @b git @b for-each-ref :
+ * le signal RefService::updated est alors émit lorsque la nouvelle liste est
+ * disponible, sauf si le dépôt a changé entre-temps.
+ */
+GitJob* RefService::refresh()
+{
+    if(!m_bTracking)
+    {
+        RefSnapshot snapshot;
+        if(m_reader.read(snapshot))
+        {
+            m_snapshot = snapshot;
+            emit updated(m_snapshot);
+            return nullptr;
+        }
+    }
+
+    GitJob* job = qGit->execute(m_workDir, RefSnapshot::queryArgs(m_bTracking), GitExecutor::ReadOnly);
+    connect(job, &GitJob::succeeded, this, [this](const GitResult& result) {
+        // Le dépôt a pu changer pendant la commande
+        if(result.workingDirectory != m_workDir)
+            return;
+        RefSnapshot snapshot;
+        if(!snapshot.parse(result.output))
+            qLog->warning("Références mal formées dans la sortie de git for-each-ref");
+        for(const QString& remote : m_reader.configRemotes())
+        {
+            snapshot.addRemote(remote);
+        }
+        m_snapshot = snapshot;
+        emit updated(m_snapshot);
+    });
+    return job;
+}
@@ -0,0 +1,208 @@
+#include "RefSnapshot.hpp"
+
+#include <cstring>
+
+#define REF_HEADS   "refs/heads/"
+#define REF_TAGS    "refs/tags/"
+#define REF_REMOTES "refs/remotes/"
+#define REF_FIELDS  6   /**< Nombre de champs par référence, séparés par un caractère nul */
+
+/**
+ * @param tracking Calculer l'avance/le retard par rapport à la branche amont
+ * @return Arguments de la commande @b git @b for-each-ref
+ *
+ * Les champs de chaque référence sont séparés par un caractère nul (@c %00)
+ * et les références par un retour à la ligne, qui ne peut pas apparaître dans
+ * un nom de référence. Le calcul d'avance/retard parcourt l'historique : il
+ * n'est demandé qu'au besoin.
+ */
+QStringList RefSnapshot::queryArgs(bool tracking /*= false*/)
+{
+    QString format = "%(refname)%00%(objectname)%00%(*objectname)%00%(HEAD)%00%(upstream)%00";
+    if(tracking)
+        format += "%(upstream:track,nobracket)";
+    return QStringList() << "for-each-ref" << "--format=" + format;
+}
+
+/**
+ * @param record Référence à compléter
+ * @param refname Nom complet de la référence
+ *
+ * Renseigne le nom complet, le nom court et le type de la référence.
+ */
+void RefSnapshot::setRefname(RefRecord& record, const QString& refname)
+{
+    record.refname = refname;
+    if(refname.startsWith(REF_HEADS))
+    {
+        record.type = RefRecord::Branch;
+        record.name = refname.mid(int(strlen(REF_HEADS)));
+    }
+    else if(refname.startsWith(REF_TAGS))
+    {
+        record.type = RefRecord::Tag;
+        record.name = refname.mid(int(strlen(REF_TAGS)));
+    }
+    else if(refname.startsWith(REF_REMOTES))
+    {
+        record.type = RefRecord::RemoteBranch;
+        record.name = refname.mid(int(strlen(REF_REMOTES)));
+    }
+    else
+    {
+        record.type = RefRecord::Other;
+        record.name = refname;
+    }
+}
+
+/**
+ * Efface toutes les références.
+ */
+void RefSnapshot::clear()
+{
+    m_records.clear();
+    m_extraRemotes.clear();
+}
+
+/**
+ * @param raw Sortie de la commande RefSnapshot::queryArgs
+ * @return @c false si une ligne est mal formée, @c true sinon
+ */
+bool RefSnapshot::parse(const QByteArray& raw)
+{
+    clear();
+    bool bOk = true;
+    const char* data = raw.constData();
+    const int size = raw.size();
+    int pos = 0;
+
+    while(pos < size)
+    {
+        const char* found = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        int end = found ? int(found - data) : size;
+
+        // Découpage des champs
+        int fields[REF_FIELDS + 1];
+        int count = 0;
+        int fieldPos = pos;
+        while(count < REF_FIELDS)
+        {
+            fields[count++] = fieldPos;
+            const char* sep = static_cast<const char*>(std::memchr(data + fieldPos, '\0', end - fieldPos));
+            if(!sep)
+                break;
+            fieldPos = int(sep - data) + 1;
+        }
+        fields[count] = end + 1;
+
+        if(count < REF_FIELDS - 1)
+        {
+            if(end > pos) bOk = false;
+            pos = end + 1;
+            continue;
+        }
+        auto field = [&](int i) {
+            return i < count ? QByteArray(data + fields[i], fields[i + 1] - fields[i] - 1) : QByteArray();
+        };
+
+        RefRecord record;
+        setRefname(record, QString::fromUtf8(field(0)));
+        record.oid = field(1);
+        record.peeled = field(2);
+        record.head = field(3) == "*";
+        record.upstream = QString::fromUtf8(field(4));
+        QByteArray track = field(5);
+        if(track == "gone")
+        {
+            record.gone = true;
+        }
+        else
+        {
+            for(const QByteArray& part : track.split(','))
+            {
+                QByteArray item = part.trimmed();
+                if(item.startsWith("ahead ")) record.ahead = item.mid(6).toInt();
+                else if(item.startsWith("behind ")) record.behind = item.mid(7).toInt();
+            }
+        }
+        m_records.append(record);
+
+        pos = end + 1;
+    }
+    return bOk;
+}
+
+/**
+ * @return Noms des branches locales
+ */
+QStringList RefSnapshot::branches() const
+{
+    QStringList result;
+    for(const RefRecord& record : m_records)
+    {
+        if(record.type == RefRecord::Branch)
+            result << record.name;
+    }
+    return result;
+}
+
+/**
+ * @return Noms des tags
+ */
+QStringList RefSnapshot::tags() const
+{
+    QStringList result;
+    for(const RefRecord& record : m_records)
+    {
+        if(record.type == RefRecord::Tag)
+            result << record.name;
+    }
+    return result;
+}
+
+/**
+ * @return Noms des dépôts distants, triés
+ *
+ * Les dépôts distants sont déduits des branches distantes (premier élément du
+ * nom court) et complétés par ceux ajoutés avec RefSnapshot::addRemote.
+ */
+QStringList RefSnapshot::remotes() const
+{
+    QStringList result = m_extraRemotes;
+    for(const RefRecord& record : m_records)
+    {
+        if(record.type == RefRecord::RemoteBranch)
+        {
+            QString remote = record.name.section('/', 0, 0);
+            if(!result.contains(remote))
+                result << remote;
+        }
+    }
+    result.sort();
+    return result;
+}
+
+/**
+ * @return Nom de la branche courante, chaîne vide si HEAD est détachée
+ */
+QString RefSnapshot::currentBranch() const
+{
+    for(const RefRecord& record : m_records)
+    {
+        if(record.head)
+            return record.name;
+    }
+    return QString();
+}
+
+/**
+ * @param remote Nom du dépôt distant
+ *
+ * Déclare un dépôt distant qui n'a peut-être encore aucune branche distante
+ * (dépôt ajouté mais jamais récupéré).
+ */
+void RefSnapshot::addRemote(const QString& remote)
+{
+    if(!m_extraRemotes.contains(remote))
+        m_extraRemotes << remote;
+}
@@ -0,0 +1,93 @@
+#include "RefreshCoalescer.hpp"
+
+#include <QStringList>
+#include "Logger.hpp"
+
+/**
+ * @param parent Le QObject parent
+ *
+ * Contructeur de la classe RefreshCoalescer.
+ */
+RefreshCoalescer::RefreshCoalescer(QObject* parent) :
+    QObject(parent),
+    m_pending(0),
+    m_merges(0)
+{
+    for(int i = 0; i < REFRESH_RESOURCES; i++)
+    {
+        m_requests[i] = 0;
+        m_totalRequests[i] = 0;
+        m_totalFlushes[i] = 0;
+    }
+    // Intervalle nul : émission dès que la boucle d'événements est libre
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &RefreshCoalescer::on_timer_timeout);
+}
+
+/**
+ * @param resources Combinaison de RefreshCoalescer::Resource
+ *
+ * Déclare les ressources invalides. Le rafraîchissement est émit au tour de
+ * boucle d'événements suivant, avec les autres demandes reçues d'ici là.
+ */
+void RefreshCoalescer::request(int resources)
+{
+    resources &= All;
+    if(resources == 0)
+        return;
+    for(int i = 0; i < REFRESH_RESOURCES; i++)
+    {
+        if(resources & (1 << i))
+        {
+            m_requests[i]++;
+            m_totalRequests[i]++;
+        }
+    }
+    m_pending |= resources;
+    if(!m_timer.isActive())
+        m_timer.start();
+}
+
+/**
+ * Ce connecteur est activé au tour de boucle d'événements suivant la première
+ * demande.@n
+ * Emet le signal RefreshCoalescer::flush et note les demandes regroupées.
+ */
+void RefreshCoalescer::on_timer_timeout()
+{
+    int resources = m_pending;
+    m_pending = 0;
+    QStringList merged;
+    for(int i = 0; i < REFRESH_RESOURCES; i++)
+    {
+        if(m_requests[i] > 0)
+            m_totalFlushes[i]++;
+        if(m_requests[i] > 1)
+            merged << QString(name(i)) + " " + QString::number(m_requests[i]) + " -> 1";
+        m_requests[i] = 0;
+    }
+    if(!merged.isEmpty())
+    {
+        qLog->info("Rafraîchissements regroupés :", merged.join(", "));
+        if(++m_merges % REFRESH_LOG_PERIOD == 0)
+        {
+            QStringList totals;
+            for(int i = 0; i < REFRESH_RESOURCES; i++)
+                totals << QString(name(i)) + " " + QString::number(m_totalRequests[i]) + " -> " + QString::number(m_totalFlushes[i]);
+            qLog->info("Bilan des rafraîchissements (demandes -> commandes) :", totals.join(", "));
+        }
+    }
+    if(resources != 0)
+        emit flush(resources);
+}
+
+/**
+ * @param index Rang du bit de la ressource
+ * @return Nom de la ressource pour le log
+ */
+const char* RefreshCoalescer::name(int index)
+{
+    static const char* names[REFRESH_RESOURCES] = { "status", "refs", "stash", "untracked" };
+    return names[index];
+}
@@ -0,0 +1,95 @@
+#include "RepoFingerprint.hpp"
+
+#include <QDirIterator>
+#include <QFileInfo>
+
+#include "RepoWatcher.hpp"
+
+#define FNV_OFFSET  Q_UINT64_C(14695981039346656037)
+#define FNV_PRIME   Q_UINT64_C(1099511628211)
+
+/**
+ * Contructeur de la classe RepoFingerprint.
+ */
+RepoFingerprint::RepoFingerprint()
+{
+    reset();
+}
+
+/**
+ * @param gitDir Dossier Git du dépôt
+ * @param commonDir Dossier Git commun (refs, packed-refs)
+ *
+ * Change le dépôt et efface l'empreinte précédente.
+ */
+void RepoFingerprint::setRepository(const QString& gitDir, const QString& commonDir)
+{
+    m_gitDir = gitDir;
+    m_commonDir = commonDir.isEmpty() ? gitDir : commonDir;
+    reset();
+}
+
+/**
+ * Efface l'empreinte : le prochain appel à RepoFingerprint::update signalera
+ * un changement.
+ */
+void RepoFingerprint::reset()
+{
+    m_status = 0;
+    m_refs = 0;
+}
+
+/**
+ * @return Combinaison de RepoWatcher::Change depuis le dernier appel
+ *
+ * Recalcule l'empreinte du dépôt et la compare à la précédente.
+ */
+int RepoFingerprint::update()
+{
+    quint64 status = FNV_OFFSET;
+    quint64 refs = FNV_OFFSET;
+
+    mix(status, m_gitDir + "/index");
+    mix(status, m_gitDir + "/HEAD");
+    mix(refs, m_gitDir + "/HEAD");
+    mix(refs, m_commonDir + "/packed-refs");
+    // Les références sont mises à jour par renommage : la date des dossiers suffit
+    mix(refs, m_commonDir + "/refs");
+    QDirIterator it(m_commonDir + "/refs", QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while(it.hasNext())
+    {
+        mix(refs, it.next());
+    }
+
+    int changes = 0;
+    if(status != m_status) changes |= RepoWatcher::StatusChange;
+    if(refs != m_refs) changes |= RepoWatcher::RefsChange;
+    m_status = status;
+    m_refs = refs;
+    return changes;
+}
+
+/**
+ * @param hash Empreinte à compléter
+ * @param path Fichier ou dossier
+ *
+ * Ajoute la taille et la date de modification de @c path à l'empreinte (FNV-1a).
+ */
+void RepoFingerprint::mix(quint64& hash, const QString& path)
+{
+    QFileInfo info(path);
+    quint64 values[2] = { 0, 0 };
+    if(info.exists())
+    {
+        values[0] = quint64(info.size());
+        values[1] = quint64(info.lastModified().toMSecsSinceEpoch());
+    }
+    for(quint64 value : values)
+    {
+        for(int i = 0; i < 8; i++)
+        {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= FNV_PRIME;
+        }
+    }
+}
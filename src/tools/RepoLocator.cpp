@@ -0,0 +1,144 @@
+#include "RepoLocator.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+
+/**
+ * @param path Dossier dont on cherche le dépôt
+ * @param location Emplacement du dépôt trouvé
+ * @return @c false si le dossier n'appartient à aucun dépôt
+ */
+bool RepoLocator::locate(const QString& path, RepoLocation& location)
+{
+    const QString key = QDir::cleanPath(QDir(path).absolutePath());
+    auto it = m_cache.constFind(key);
+    if(it != m_cache.constEnd() && QFileInfo(it->gitDir + "/HEAD").isFile())
+    {
+        location = *it;
+        return true;
+    }
+    m_cache.remove(key);
+
+    location = RepoLocation();
+    if(!find(key, location))
+        return false;
+    m_cache.insert(key, location);
+    return true;
+}
+
+/**
+ * @param path Dossier absolu
+ * @param location Emplacement du dépôt trouvé
+ * @return @c false si le dossier n'appartient à aucun dépôt
+ */
+bool RepoLocator::find(const QString& path, RepoLocation& location)
+{
+    QDir base(path);
+
+    // GIT_DIR : la copie de travail est GIT_WORK_TREE, à défaut le dossier lui-même
+    QString envDir = QString::fromLocal8Bit(qgetenv("GIT_DIR"));
+    if(!envDir.isEmpty())
+    {
+        QString gitDir = QDir::cleanPath(base.absoluteFilePath(envDir));
+        if(!isGitDir(gitDir))
+            return false;
+        QString envTree = QString::fromLocal8Bit(qgetenv("GIT_WORK_TREE"));
+        location.gitDir = gitDir;
+        location.commonDir = commonDir(gitDir);
+        location.workTree = QDir::cleanPath(envTree.isEmpty() ? path : base.absoluteFilePath(envTree));
+        return true;
+    }
+
+    QStringList ceilings;
+    for(const QString& ceiling : QString::fromLocal8Bit(qgetenv("GIT_CEILING_DIRECTORIES")).split(QDir::listSeparator(), QString::SkipEmptyParts))
+        ceilings << QDir::cleanPath(ceiling);
+
+    QString dir = path;
+    while(true)
+    {
+        QFileInfo dotGit(dir + "/.git");
+        QString gitDir;
+        if(dotGit.isDir() && isGitDir(dotGit.filePath()))
+        {
+            gitDir = dotGit.filePath();
+        }
+        else if(dotGit.isFile())
+        {
+            // Worktree ou sous-module : "gitdir: <chemin>", relatif au dossier du fichier
+            QString target = readGitFile(dotGit.filePath());
+            if(!target.isEmpty())
+            {
+                target = QDir::cleanPath(QDir(dir).absoluteFilePath(target));
+                if(isGitDir(target))
+                    gitDir = target;
+            }
+        }
+        if(!gitDir.isEmpty())
+        {
+            location.gitDir = gitDir;
+            location.commonDir = commonDir(gitDir);
+            location.workTree = dir;
+            return true;
+        }
+        if(isGitDir(dir))
+        {
+            // Dépôt nu, ou recherche depuis l'intérieur d'un dossier .git
+            location.gitDir = dir;
+            location.commonDir = commonDir(dir);
+            return true;
+        }
+
+        QString parent = QFileInfo(dir).path();
+        if(parent == dir || ceilings.contains(parent))
+            return false;
+        dir = parent;
+    }
+}
+
+/**
+ * @param dir Dossier à tester
+ * @return @c true si le dossier contient @c HEAD et, dans son dossier commun,
+ * @c objects et @c refs
+ */
+bool RepoLocator::isGitDir(const QString& dir)
+{
+    if(!QFileInfo(dir + "/HEAD").isFile())
+        return false;
+    QString common = commonDir(dir);
+    return QFileInfo(common + "/objects").isDir() && QFileInfo(common + "/refs").isDir();
+}
+
+/**
+ * @param gitDir Dossier Git
+ * @return Dossier commun, lu dans le fichier @c commondir des worktrees
+ * (relatif au dossier Git), ou le dossier Git lui-même
+ */
+QString RepoLocator::commonDir(const QString& gitDir)
+{
+    QFile file(gitDir + "/commondir");
+    if(!file.open(QIODevice::ReadOnly))
+        return gitDir;
+    QString common = QString::fromLocal8Bit(file.readLine().trimmed());
+    file.close();
+    if(common.isEmpty())
+        return gitDir;
+    return QDir::cleanPath(QDir(gitDir).absoluteFilePath(common));
+}
+
+/**
+ * @param file Fichier @c .git
+ * @return Chemin indiqué par la ligne @c gitdir:, vide si le fichier n'en contient pas
+ */
+QString RepoLocator::readGitFile(const QString& file)
+{
+    QFile gitFile(file);
+    if(!gitFile.open(QIODevice::ReadOnly))
+        return QString();
+    QByteArray line = gitFile.readLine(4096).trimmed();
+    gitFile.close();
+    if(!line.startsWith("gitdir:"))
+        return QString();
+    return QString::fromLocal8Bit(line.mid(7).trimmed());
+}
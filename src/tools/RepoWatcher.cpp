@@ -0,0 +1,358 @@
+#include "RepoWatcher.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "GitExecutor.hpp"
+#include "Logger.hpp"
+
+#define DEBOUNCE_DEFAULT_MS     300     /**< Délai de regroupement par défaut */
+#define DEBOUNCE_MAX_WAIT_MS    2000    /**< Attente maximale avant émission malgré de nouvelles notifications */
+#define MAX_WORKTREE_DIRS       8192    /**< Nombre maximal de dossiers de la copie de travail surveillés */
+
+/**
+ * @param parent Objet parent
+ *
+ * Contructeur de la classe RepoWatcher. La surveillance n'est lancée que par
+ * la fonction RepoWatcher::start.
+ */
+RepoWatcher::RepoWatcher(QObject* parent) :
+    QObject(parent),
+    m_watcher(nullptr),
+    m_pending(0),
+    m_bActive(false),
+    m_bWorkTree(false),
+    m_generation(0)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(DEBOUNCE_DEFAULT_MS);
+    connect(&m_debounce, &QTimer::timeout, this, &RepoWatcher::on_debounce_timeout);
+}
+
+/**
+ * @param gitDir Dossier Git du dépôt (contient @c index et @c HEAD)
+ * @param commonDir Dossier Git commun (contient @c refs et @c packed-refs)
+ * @param workTree Racine de la copie de travail
+ *
+ * Change le dépôt surveillé. Si la surveillance est active, elle est relancée
+ * sur le nouveau dépôt.
+ */
+void RepoWatcher::setRepository(const QString& gitDir, const QString& commonDir, const QString& workTree)
+{
+    m_gitDir = QDir::cleanPath(gitDir);
+    m_commonDir = QDir::cleanPath(commonDir.isEmpty() ? gitDir : commonDir);
+    m_workTree = QDir::cleanPath(workTree);
+    if(m_bActive)
+    {
+        start();
+    }
+}
+
+/**
+ * @param enable Activation de la surveillance de la copie de travail
+ */
+void RepoWatcher::setWatchWorkTree(bool enable)
+{
+    m_bWorkTree = enable;
+    if(m_bActive)
+    {
+        start();
+    }
+}
+
+/**
+ * Démarre (ou redémarre) la surveillance du dépôt.@n
+ * La copie de travail n'est surveillée qu'après la lecture de ses dossiers
+ * ignorés par @b git @b ls-files, qui ne bloque pas l'IHM.
+ */
+void RepoWatcher::start()
+{
+    stop();
+    if(m_gitDir.isEmpty())
+        return;
+
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &RepoWatcher::on_directoryChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &RepoWatcher::on_fileChanged);
+
+    m_watcher->addPath(m_gitDir);
+    if(m_commonDir != m_gitDir)
+        m_watcher->addPath(m_commonDir);
+    m_stamps.clear();
+    checkGitFiles();
+    m_debounce.stop(); // L'état initial n'est pas une modification
+    m_pending = 0;
+    watchTree(m_commonDir + "/refs", false);
+
+    m_bActive = true;
+    qLog->info("Surveillance du dépôt", m_gitDir, ":",
+               m_watcher->directories().length(), "dossiers,",
+               m_watcher->files().length(), "fichiers");
+
+    if(m_bWorkTree && !m_workTree.isEmpty())
+    {
+        int generation = m_generation;
+        GitJob* job = qGit->execute(m_workTree, QStringList() << "ls-files" << "-z" << "--others" << "--ignored"
+                                                              << "--exclude-standard" << "--directory", GitExecutor::ReadOnly);
+        connect(job, &GitJob::finished, this, [this, generation](const GitResult& result) {
+            if(generation != m_generation || !m_watcher)
+                return;
+            if(result.success())
+            {
+                // Dossiers ignorés, avec un '/' final
+                for(const QByteArray& entry : result.output.split('\0'))
+                {
+                    if(entry.endsWith('/'))
+                        m_ignored.insert(m_workTree + '/' + QString::fromUtf8(entry.left(entry.size() - 1)));
+                }
+            }
+            watchTree(m_workTree, true);
+            if(m_treeDirs.size() >= MAX_WORKTREE_DIRS)
+                qLog->warning("Surveillance limitée à", MAX_WORKTREE_DIRS, "dossiers de la copie de travail");
+            qLog->info("Surveillance de la copie de travail :", m_treeDirs.size(), "dossiers,",
+                       m_ignored.size(), "dossiers ignorés");
+        });
+    }
+}
+
+/**
+ * Arrête la surveillance. Les modifications en attente sont abandonnées.
+ */
+void RepoWatcher::stop()
+{
+    m_debounce.stop();
+    m_pending = 0;
+    m_bActive = false;
+    m_generation++;
+    m_watched.clear();
+    m_treeDirs.clear();
+    m_ignored.clear();
+    delete m_watcher;
+    m_watcher = nullptr;
+}
+
+/**
+ * @param path Dossier modifié
+ *
+ * Une modification d'un dossier Git peut correspondre au remplacement de
+ * @c index, @c HEAD ou @c packed-refs (écriture par fichier @c .lock puis
+ * renommage). Une modification dans @c refs ou dans la copie de travail peut
+ * aussi correspondre à la création d'un sous-dossier à surveiller, ou à la
+ * suppression du dossier lui-même, qui est alors oublié.
+ */
+void RepoWatcher::on_directoryChanged(const QString& path)
+{
+    if(path == m_gitDir || path == m_commonDir)
+    {
+        checkGitFiles();
+        return;
+    }
+    bool bRefs = path.startsWith(m_commonDir + "/refs");
+    if(!bRefs && (!m_bWorkTree || path.startsWith(m_gitDir)))
+        return;
+    if(!QFileInfo::exists(path))
+        forget(path);
+    else if(bRefs)
+        watchTree(path, false);
+    else
+        watchWorkTreeDirs(path);
+    notify(bRefs ? RefsChange : StatusChange);
+}
+
+/**
+ * @param path Fichier modifié
+ */
+void RepoWatcher::on_fileChanged(const QString&)
+{
+    checkGitFiles();
+}
+
+/**
+ * Emet le signal RepoWatcher::changed avec les modifications regroupées.
+ */
+void RepoWatcher::on_debounce_timeout()
+{
+    int changes = m_pending;
+    m_pending = 0;
+    if(changes != 0)
+    {
+        emit changed(changes);
+    }
+}
+
+/**
+ * @param path Fichier à surveiller
+ *
+ * Ajoute le fichier à la surveillance s'il existe et n'est pas déjà surveillé.
+ * Git remplace ses fichiers par renommage, ce qui met fin à leur surveillance :
+ * cette fonction est donc rappelée à chaque vérification.
+ */
+void RepoWatcher::watchFile(const QString& path)
+{
+    if(QFileInfo::exists(path) && !m_watcher->files().contains(path))
+    {
+        m_watcher->addPath(path);
+    }
+}
+
+/**
+ * @param dir Dossier racine
+ * @param skipGitDir Ignorer les dossiers @c .git et appliquer la limite
+ * #MAX_WORKTREE_DIRS (copie de travail)
+ *
+ * Ajoute récursivement le dossier @c dir et ses sous-dossiers à la surveillance.
+ */
+void RepoWatcher::watchTree(const QString& dir, bool skipGitDir)
+{
+    if(!m_watcher)
+        return;
+    QStringList todo;
+    todo << dir;
+    while(!todo.isEmpty())
+    {
+        QString current = todo.takeLast();
+        if(skipGitDir && m_treeDirs.size() >= MAX_WORKTREE_DIRS)
+            return;
+        if(!m_watched.contains(current))
+        {
+            if(!m_watcher->addPath(current))
+                continue;
+            m_watched.insert(current);
+            if(skipGitDir)
+                m_treeDirs.insert(current);
+        }
+        QDir qdir(current);
+        for(const QString& sub : qdir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks))
+        {
+            if(skipGitDir && sub == ".git")
+                continue;
+            QString subPath = current + '/' + sub;
+            if(!m_watched.contains(subPath) && !(skipGitDir && m_ignored.contains(subPath)))
+                todo << subPath;
+        }
+    }
+}
+
+/**
+ * @param dir Dossier modifié de la copie de travail
+ *
+ * Recherche les nouveaux sous-dossiers de @c dir et les fait vérifier par
+ * @b git @b check-ignore : seuls ceux qui ne sont pas ignorés sont surveillés
+ * (voir RepoWatcher::watchTree).
+ */
+void RepoWatcher::watchWorkTreeDirs(const QString& dir)
+{
+    QStringList added;
+    for(const QString& sub : QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks))
+    {
+        QString subPath = dir + '/' + sub;
+        if(sub != ".git" && !m_watched.contains(subPath) && !m_ignored.contains(subPath))
+            added << subPath;
+    }
+    if(added.isEmpty())
+        return;
+
+    int generation = m_generation;
+    GitJob* job = qGit->execute(m_workTree, QStringList() << "check-ignore" << "-z" << "--" << added, GitExecutor::ReadOnly);
+    connect(job, &GitJob::finished, this, [this, generation, added](const GitResult& result) {
+        if(generation != m_generation || !m_watcher)
+            return;
+        // Code retour 1 : aucun dossier ignoré, autre erreur : tous sont surveillés
+        if(result.exitCode == 0)
+        {
+            for(const QByteArray& entry : result.output.split('\0'))
+            {
+                if(!entry.isEmpty())
+                    m_ignored.insert(QDir::cleanPath(QString::fromUtf8(entry)));
+            }
+        }
+        for(const QString& subPath : added)
+        {
+            if(!m_ignored.contains(subPath))
+                watchTree(subPath, true);
+        }
+    });
+}
+
+/**
+ * @param dir Dossier supprimé
+ *
+ * Retire le dossier et ses sous-dossiers de la surveillance et des compteurs,
+ * pour que la limite #MAX_WORKTREE_DIRS ne soit pas consommée par des
+ * dossiers disparus.
+ */
+void RepoWatcher::forget(const QString& dir)
+{
+    const QString prefix = dir + '/';
+    QSet<QString>* sets[] = { &m_watched, &m_treeDirs, &m_ignored };
+    for(QSet<QString>* set : sets)
+    {
+        QMutableSetIterator<QString> it(*set);
+        while(it.hasNext())
+        {
+            const QString& path = it.next();
+            if(path == dir || path.startsWith(prefix))
+            {
+                if(set == &m_watched && m_watcher)
+                    m_watcher->removePath(path);
+                it.remove();
+            }
+        }
+    }
+}
+
+/**
+ * Compare les dates de modification de @c index, @c HEAD et @c packed-refs
+ * avec celles de la dernière vérification et notifie les changements.
+ */
+void RepoWatcher::checkGitFiles()
+{
+    struct GitFile { QString path; int change; };
+    const GitFile files[] = {
+        { m_gitDir + "/index", StatusChange },
+        { m_gitDir + "/HEAD", RefsChange | StatusChange },
+        { m_commonDir + "/packed-refs", RefsChange }
+    };
+
+    int changes = 0;
+    for(const GitFile& file : files)
+    {
+        QFileInfo info(file.path);
+        QDateTime stamp = info.exists() ? info.lastModified() : QDateTime();
+        if(m_stamps.value(file.path) != stamp)
+        {
+            m_stamps.insert(file.path, stamp);
+            changes |= file.change;
+        }
+        watchFile(file.path);
+    }
+    if(changes != 0)
+    {
+        notify(changes);
+    }
+}
+
+/**
+ * @param changes Combinaison de RepoWatcher::Change
+ *
+ * Ajoute les modifications à émettre et relance le délai de regroupement.
+ * Si des notifications arrivent en continu, l'émission a lieu au plus tard
+ * #DEBOUNCE_MAX_WAIT_MS millisecondes après la première.
+ */
+void RepoWatcher::notify(int changes)
+{
+    if(m_pending == 0)
+    {
+        m_firstChange.start();
+    }
+    m_pending |= changes;
+    if(m_firstChange.elapsed() >= DEBOUNCE_MAX_WAIT_MS)
+    {
+        m_debounce.stop();
+        on_debounce_timeout();
+    }
+    else
+    {
+        m_debounce.start();
+    }
+}
@@ -0,0 +1,273 @@
+#include "StagedIndex.hpp"
+
+#include <QFile>
+#include <QHash>
+
+#include <algorithm>
+#include <cstring>
+
+#define MODE_TYPE_MASK  0170000     /**< Type de fichier dans un mode Git */
+
+/**
+ * Contructeur de la classe StagedIndex.
+ */
+StagedIndex::StagedIndex() :
+    m_objectFormat(INDEX_OID_FORMAT),
+    m_bSupported(true)
+{
+}
+
+/**
+ * @param gitDir Dossier Git du dépôt (contient @c index et @c HEAD)
+ * @param commonDir Dossier Git commun (contient @c refs et @c packed-refs)
+ *
+ * Change le dépôt et efface la référence. Le format des identifiants d'objet
+ * du dépôt est lu une fois pour toutes (voir IndexReader::objectFormat).
+ */
+void StagedIndex::setRepository(const QString& gitDir, const QString& commonDir)
+{
+    m_gitDir = gitDir;
+    m_commonDir = commonDir.isEmpty() ? gitDir : commonDir;
+    m_objectFormat = IndexReader::objectFormat(m_commonDir);
+    m_bSupported = true;
+    clear();
+}
+
+/**
+ * Efface la référence.
+ */
+void StagedIndex::clear()
+{
+    m_checksum.clear();
+    m_head.clear();
+    m_entries.clear();
+    m_paths.clear();
+}
+
+/**
+ * @return Commit pointé par HEAD (hexadécimal), vide s'il n'a pas pu être lu
+ *
+ * HEAD est lu directement dans les fichiers du dépôt : référence symbolique
+ * vers une référence individuelle ou contenue dans @c packed-refs, ou HEAD
+ * détachée.
+ */
+QByteArray StagedIndex::readHead() const
+{
+    QFile head(m_gitDir + "/HEAD");
+    if(!head.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QByteArray content = head.readAll().trimmed();
+    head.close();
+    if(!content.startsWith("ref: "))
+        return content;
+
+    QByteArray ref = content.mid(5);
+    QFile loose(m_commonDir + '/' + QString::fromUtf8(ref));
+    if(loose.open(QIODevice::ReadOnly))
+        return loose.readAll().trimmed();
+
+    QFile packed(m_commonDir + "/packed-refs");
+    if(packed.open(QIODevice::ReadOnly))
+    {
+        while(!packed.atEnd())
+        {
+            QByteArray line = packed.readLine().trimmed();
+            int space = line.indexOf(' ');
+            if(space > 0 && line.mid(space + 1) == ref)
+                return line.left(space);
+        }
+    }
+    return QByteArray();
+}
+
+/**
+ * @param index Lecteur à ouvrir sur l'index du dépôt
+ * @return @c true si l'index a été lu
+ *
+ * Un format non supporté est mémorisé : StagedIndex::isSupported renvoie alors
+ * @c false jusqu'au prochain changement de dépôt.
+ */
+bool StagedIndex::open(IndexReader& index)
+{
+    if(!m_bSupported)
+        return false;
+    if(index.open(indexPath(), m_objectFormat))
+        return true;
+    if(index.error() == IndexReader::Unsupported)
+    {
+        m_bSupported = false;
+        clear();
+    }
+    return false;
+}
+
+/**
+ * @param index Index lu au moment du status
+ * @param status Résultat du @b git @b status
+ * @param head Commit HEAD au moment du status
+ * @return @c true si la référence a été construite
+ */
+bool StagedIndex::rebuild(const IndexReader& index, const StatusParser& status, const QByteArray& head)
+{
+    clear();
+    if(head.isEmpty() || !index.isOpen())
+        return false;
+
+    // Chemins dont l'état dans HEAD diffère de l'index
+    QHash<QByteArray, const StatusEntry*> staged;
+    for(const StatusEntry& entry : status.entries())
+    {
+        if(entry.kind == StatusEntry::Unmerged)
+            return false;
+        if(entry.isStaged())
+            staged.insert(status.rawPath(entry), &entry);
+    }
+
+    m_entries.reserve(index.entries().length() + staged.size());
+    m_paths.reserve(index.entries().length() * 32);
+    bool bSorted = true;
+    for(const IndexEntry& entry : index.entries())
+    {
+        if(entry.stage() != 0)
+        {
+            clear();
+            return false;
+        }
+        if(entry.isIntentToAdd())
+            continue;
+        const StatusEntry* changed = staged.value(QByteArray::fromRawData(entry.path, entry.pathLength));
+        if(!changed)
+        {
+            append(entry.path, entry.pathLength, entry.mode(), entry.oid());
+        }
+        else if(changed->kind == StatusEntry::Ordinary && changed->x != 'A')
+        {
+            QByteArray oid = QByteArray::fromHex(status.field(*changed, 4));
+            if(oid.length() != INDEX_OID_SIZE)
+            {
+                clear();
+                return false;
+            }
+            append(entry.path, entry.pathLength, status.field(*changed, 1).toUInt(nullptr, 8),
+                   reinterpret_cast<const uchar*>(oid.constData()));
+        }
+    }
+
+    // Chemins présents dans HEAD mais plus dans l'index
+    for(const StatusEntry* changed : staged)
+    {
+        QByteArray path;
+        if(changed->kind == StatusEntry::Ordinary && changed->x == 'D')
+            path = status.rawPath(*changed);
+        else if(changed->kind == StatusEntry::Renamed && changed->x == 'R')
+            path = status.raw().mid(changed->orig, changed->origLength);
+        else
+            continue;
+        QByteArray oid = QByteArray::fromHex(status.field(*changed, 4));
+        if(oid.length() != INDEX_OID_SIZE)
+        {
+            clear();
+            return false;
+        }
+        append(path.constData(), path.length(), status.field(*changed, 1).toUInt(nullptr, 8),
+               reinterpret_cast<const uchar*>(oid.constData()));
+        bSorted = false;
+    }
+    if(!bSorted)
+    {
+        std::sort(m_entries.begin(), m_entries.end(), [this](const HeadEntry& a, const HeadEntry& b) {
+            return compare(a, m_paths.constData() + b.path, b.pathLength) < 0;
+        });
+    }
+
+    m_checksum = index.checksum();
+    m_head = head;
+    return true;
+}
+
+/**
+ * @param index Nouvel index
+ * @param changes Modifications indexées, remplies par cette fonction
+ * @return @c false si la référence est invalide ou si l'index contient des
+ * conflits
+ *
+ * L'index et la référence étant triés par chemin, la comparaison se fait en
+ * un seul parcours, sans table de hachage ni allocation par entrée.
+ */
+bool StagedIndex::diff(const IndexReader& index, QVector<StagedChange>& changes) const
+{
+    changes.clear();
+    if(!isValid() || !index.isOpen())
+        return false;
+
+    const int count = m_entries.length();
+    int h = 0;
+    for(const IndexEntry& entry : index.entries())
+    {
+        if(entry.stage() != 0)
+        {
+            changes.clear();
+            return false;
+        }
+        if(entry.isIntentToAdd())
+            continue;
+
+        int cmp = -1;
+        while(h < count && (cmp = compare(m_entries.at(h), entry.path, entry.pathLength)) < 0)
+        {
+            const HeadEntry& head = m_entries.at(h++);
+            changes.append({ QString::fromUtf8(m_paths.constData() + head.path, head.pathLength), 'D' });
+        }
+        if(h < count && cmp == 0)
+        {
+            const HeadEntry& head = m_entries.at(h++);
+            quint32 mode = entry.mode();
+            if((head.mode & MODE_TYPE_MASK) != (mode & MODE_TYPE_MASK))
+                changes.append({ QString::fromUtf8(entry.path, entry.pathLength), 'T' });
+            else if(head.mode != mode || std::memcmp(head.oid, entry.oid(), INDEX_OID_SIZE) != 0)
+                changes.append({ QString::fromUtf8(entry.path, entry.pathLength), 'M' });
+        }
+        else
+        {
+            changes.append({ QString::fromUtf8(entry.path, entry.pathLength), 'A' });
+        }
+    }
+    while(h < count)
+    {
+        const HeadEntry& head = m_entries.at(h++);
+        changes.append({ QString::fromUtf8(m_paths.constData() + head.path, head.pathLength), 'D' });
+    }
+    return true;
+}
+
+/**
+ * @param path Chemin
+ * @param length Longueur du chemin
+ * @param mode Mode du fichier
+ * @param oid Objet du fichier (INDEX_OID_SIZE octets)
+ */
+void StagedIndex::append(const char* path, int length, quint32 mode, const uchar* oid)
+{
+    HeadEntry entry;
+    entry.path = m_paths.length();
+    entry.pathLength = length;
+    entry.mode = mode;
+    std::memcpy(entry.oid, oid, INDEX_OID_SIZE);
+    m_paths.append(path, length);
+    m_entries.append(entry);
+}
+
+/**
+ * @param head Entrée de la référence
+ * @param path Chemin
+ * @param length Longueur du chemin
+ * @return Résultat négatif, nul ou positif selon l'ordre de l'index Git
+ * (comparaison octet par octet, le plus court en premier)
+ */
+int StagedIndex::compare(const HeadEntry& head, const char* path, int length) const
+{
+    int cmp = std::memcmp(m_paths.constData() + head.path, path, size_t(qMin(head.pathLength, length)));
+    if(cmp != 0)
+        return cmp;
+    return head.pathLength - length;
+}
@@ -0,0 +1,210 @@
+#include "StatusCache.hpp"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include "Logger.hpp"
+#include "RepoFingerprint.hpp"
+
+/**
+ * @param stream Flux de sortie
+ * @param item Ligne à écrire
+ */
+static QDataStream& operator<<(QDataStream& stream, const StatusItem& item)
+{
+    return stream << item.path << item.text;
+}
+
+/**
+ * @param stream Flux d'entrée
+ * @param item Ligne lue
+ */
+static QDataStream& operator>>(QDataStream& stream, StatusItem& item)
+{
+    return stream >> item.path >> item.text;
+}
+
+/**
+ * @param stream Flux de sortie
+ * @param record Référence à écrire
+ */
+static QDataStream& operator<<(QDataStream& stream, const RefRecord& record)
+{
+    return stream << quint8(record.type) << record.refname << record.name << record.oid << record.peeled
+                  << record.upstream << qint32(record.ahead) << qint32(record.behind) << record.gone << record.head;
+}
+
+/**
+ * @param stream Flux d'entrée
+ * @param record Référence lue
+ */
+static QDataStream& operator>>(QDataStream& stream, RefRecord& record)
+{
+    quint8 type;
+    qint32 ahead, behind;
+    stream >> type >> record.refname >> record.name >> record.oid >> record.peeled
+           >> record.upstream >> ahead >> behind >> record.gone >> record.head;
+    record.type = RefRecord::Type(type);
+    record.ahead = ahead;
+    record.behind = behind;
+    return stream;
+}
+
+/**
+ * Contructeur de la classe StatusCache.
+ */
+StatusCache::StatusCache() :
+    m_statusStamp(0),
+    m_refsStamp(0)
+{
+}
+
+/**
+ * @param path Dossier du dépôt
+ * @param gitDir Dossier Git du dépôt
+ * @param commonDir Dossier Git commun
+ *
+ * Change le dépôt enregistré. Les empreintes sont effacées jusqu'à la
+ * réception de nouvelles données.
+ */
+void StatusCache::setRepository(const QString& path, const QString& gitDir, const QString& commonDir)
+{
+    m_path = QDir::cleanPath(path);
+    m_gitDir = gitDir;
+    m_commonDir = commonDir;
+    m_statusStamp = 0;
+    m_refsStamp = 0;
+}
+
+/**
+ * Oublie le dépôt : plus rien ne sera enregistré.
+ */
+void StatusCache::clear()
+{
+    setRepository(QString(), QString(), QString());
+}
+
+/**
+ * @param path Dossier d'exécution du status reçu
+ *
+ * Relève l'empreinte de l'index et de HEAD, à appeler à la réception d'un
+ * status. Sans effet si le status provient d'un autre dépôt.
+ */
+void StatusCache::statusUpdated(const QString& path)
+{
+    if(!isValid() || QDir::cleanPath(path) != m_path)
+        return;
+    RepoFingerprint fingerprint;
+    fingerprint.setRepository(m_gitDir, m_commonDir);
+    fingerprint.update();
+    m_statusStamp = fingerprint.statusStamp();
+}
+
+/**
+ * Relève l'empreinte des références, à appeler à la réception des références.
+ */
+void StatusCache::refsUpdated()
+{
+    if(!isValid())
+        return;
+    RepoFingerprint fingerprint;
+    fingerprint.setRepository(m_gitDir, m_commonDir);
+    fingerprint.update();
+    m_refsStamp = fingerprint.refsStamp();
+}
+
+/**
+ * @param path Dossier du dépôt
+ * @return Chemin du fichier de cache du dépôt
+ */
+QString StatusCache::fileName(const QString& path)
+{
+    QByteArray key = QCryptographicHash::hash(QDir::cleanPath(path).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString(CACHE_DIR) + '/' + QString::fromLatin1(key) + ".bin";
+}
+
+/**
+ * @param status Etat affiché
+ * @return @c true si le fichier a été écrit
+ *
+ * Enregistre l'état du dépôt courant. Seules les parties reçues depuis le
+ * changement de dépôt sont marquées valides. L'écriture passe par un fichier
+ * temporaire : un fichier de cache n'est jamais à moitié écrit.
+ */
+bool StatusCache::save(const CachedStatus& status) const
+{
+    if(!isValid() || (m_statusStamp == 0 && m_refsStamp == 0))
+        return false;
+    QDir().mkpath(CACHE_DIR);
+    QSaveFile file(fileName(m_path));
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qLog->warning("Echec d'écriture du cache :", file.fileName());
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.writeRawData(CACHE_MAGIC, 4);
+    stream << quint8(CACHE_VERSION) << m_path << m_gitDir << m_commonDir
+           << m_statusStamp << status.staged << status.unstaged << status.unmerged
+           << m_refsStamp << status.refs.records() << status.refs.remotes()
+           << status.stash;
+    return file.commit();
+}
+
+/**
+ * @param path Dossier du dépôt
+ * @param status Etat lu
+ * @return @c true si au moins une partie du cache est valide
+ *
+ * Lit le cache du dépôt @c path et compare les empreintes enregistrées à
+ * celles des fichiers Git actuels (sans lancer de processus).
+ */
+bool StatusCache::load(const QString& path, CachedStatus& status)
+{
+    status = CachedStatus();
+    QFile file(fileName(path));
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    char magic[4];
+    quint8 version = 0;
+    if(stream.readRawData(magic, 4) != 4 || qstrncmp(magic, CACHE_MAGIC, 4) != 0)
+        return false;
+    stream >> version;
+    if(version != CACHE_VERSION)
+        return false;
+
+    QString repo, gitDir, commonDir;
+    quint64 statusStamp, refsStamp;
+    QVector<RefRecord> records;
+    QStringList remotes;
+    stream >> repo >> gitDir >> commonDir
+           >> statusStamp >> status.staged >> status.unstaged >> status.unmerged
+           >> refsStamp >> records >> remotes
+           >> status.stash;
+    if(stream.status() != QDataStream::Ok || repo != QDir::cleanPath(path))
+        return false;
+
+    RepoFingerprint fingerprint;
+    fingerprint.setRepository(gitDir, commonDir);
+    fingerprint.update();
+    status.statusValid = statusStamp != 0 && statusStamp == fingerprint.statusStamp();
+    status.refsValid = refsStamp != 0 && refsStamp == fingerprint.refsStamp();
+    if(!status.statusValid)
+    {
+        status.staged.clear();
+        status.unstaged.clear();
+        status.unmerged.clear();
+    }
+    if(status.refsValid)
+    {
+        status.refs.records() = records;
+        for(const QString& remote : remotes)
+            status.refs.addRemote(remote);
+    }
+    return status.statusValid || status.refsValid;
+}
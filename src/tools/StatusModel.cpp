@@ -0,0 +1,250 @@
+#include "StatusModel.hpp"
+
+#include <algorithm>
+#include <QColor>
+#include <QFont>
+
+#define STATUS_MAX_RANGES   32      /**< Nombre de plages insérées ou supprimées au delà duquel la liste est reconstruite */
+
+/**
+ * @param a Première ligne
+ * @param b Seconde ligne
+ * @return @c true si @c a est avant @c b
+ */
+static bool lessByPath(const StatusItem& a, const StatusItem& b)
+{
+    return a.path < b.path;
+}
+
+/**
+ * @param parent Objet parent
+ *
+ * Contructeur de la classe StatusModel.
+ */
+StatusModel::StatusModel(QObject* parent) :
+    QAbstractListModel(parent),
+    m_bStale(false)
+{
+}
+
+int StatusModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_items.length();
+}
+
+QVariant StatusModel::data(const QModelIndex& index, int role) const
+{
+    if(!index.isValid() || index.row() >= m_items.length())
+        return QVariant();
+    if(role == Qt::DisplayRole)
+        return m_items.at(index.row()).text;
+    if(role == PathRole)
+        return m_items.at(index.row()).path;
+    if(m_bStale && role == Qt::ForegroundRole)
+        return QColor(Qt::gray);
+    if(m_bStale && role == Qt::FontRole)
+    {
+        QFont font;
+        font.setItalic(true);
+        return font;
+    }
+    return QVariant();
+}
+
+/**
+ * @param items Nouvelles lignes (dans un ordre quelconque)
+ *
+ * Remplace le contenu du modèle par @c items en notifiant uniquement :
+ * @li la suppression des chemins disparus, par plages contiguës
+ * @li la modification des lignes dont le texte a changé
+ * @li l'insertion des nouveaux chemins, regroupés par position d'insertion
+ *
+ * Les lignes inchangées ne génèrent aucune notification. Au delà de
+ * #STATUS_MAX_RANGES plages insérées ou supprimées, chaque notification
+ * coûterait un déplacement des lignes suivantes : la liste est alors
+ * reconstruite en une passe (voir StatusModel::rebuild). Les lignes ne sont
+ * plus marquées anciennes.
+ */
+void StatusModel::update(QVector<StatusItem> items)
+{
+    std::sort(items.begin(), items.end(), lessByPath);
+
+    // Nombre de plages insérées ou supprimées, par fusion des deux listes triées
+    int ranges = 0;
+    int previous = 0;// 0 : ligne conservée, 1 : suppression, 2 : insertion
+    int oldRow = 0;
+    int newRow = 0;
+    while(oldRow < m_items.length() || newRow < items.length())
+    {
+        int current;
+        if(newRow == items.length() || (oldRow < m_items.length() && lessByPath(m_items.at(oldRow), items.at(newRow))))
+        {
+            current = 1;
+            oldRow++;
+        }
+        else if(oldRow == m_items.length() || lessByPath(items.at(newRow), m_items.at(oldRow)))
+        {
+            current = 2;
+            newRow++;
+        }
+        else
+        {
+            current = 0;
+            oldRow++;
+            newRow++;
+        }
+        if(current != 0 && current != previous)
+            ranges++;
+        previous = current;
+    }
+    if(ranges > STATUS_MAX_RANGES)
+    {
+        rebuild(items);
+        setStale(false);
+        return;
+    }
+
+    QHash<QString, int> incoming;
+    incoming.reserve(items.length());
+    for(int i = 0; i < items.length(); i++)
+    {
+        incoming.insert(items.at(i).path, i);
+    }
+
+    // Suppressions (en partant de la fin pour conserver les index)
+    int last = m_items.length() - 1;
+    while(last >= 0)
+    {
+        if(incoming.contains(m_items.at(last).path))
+        {
+            last--;
+            continue;
+        }
+        int first = last;
+        while(first > 0 && !incoming.contains(m_items.at(first - 1).path))
+            first--;
+        beginRemoveRows(QModelIndex(), first, last);
+        m_items.remove(first, last - first + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    // Modifications, les lignes restantes sont retirées de items
+    QVector<bool> known(items.length(), false);
+    for(int row = 0; row < m_items.length(); row++)
+    {
+        int i = incoming.value(m_items.at(row).path);
+        known[i] = true;
+        if(m_items.at(row).text != items.at(i).text)
+        {
+            m_items[row].text = items.at(i).text;
+            QModelIndex idx = index(row);
+            emit dataChanged(idx, idx, QVector<int>() << Qt::DisplayRole);
+        }
+    }
+    QVector<StatusItem> added;
+    for(int i = 0; i < items.length(); i++)
+    {
+        if(!known.at(i))
+            added.append(items.at(i));
+    }
+
+    // Insertions (déjà triées), regroupées par position
+    if(!added.isEmpty())
+    {
+        int i = 0;
+        while(i < added.length())
+        {
+            int pos = int(std::lower_bound(m_items.begin(), m_items.end(), added.at(i), lessByPath) - m_items.begin());
+            int j = i + 1;
+            while(j < added.length() && (pos == m_items.length() || !lessByPath(m_items.at(pos), added.at(j))))
+                j++;
+            beginInsertRows(QModelIndex(), pos, pos + (j - i) - 1);
+            m_items.insert(pos, j - i, StatusItem());
+            for(int k = i; k < j; k++)
+            {
+                m_items[pos + k - i] = added.at(k);
+            }
+            endInsertRows();
+            i = j;
+        }
+    }
+    setStale(false);
+}
+
+/**
+ * Vide le modèle.
+ */
+void StatusModel::clear()
+{
+    beginResetModel();
+    m_items.clear();
+    m_bStale = false;
+    endResetModel();
+}
+
+/**
+ * @param stale Les lignes proviennent du cache
+ *
+ * Marque les lignes comme anciennes (ou à jour) et notifie la vue du
+ * changement d'apparence.
+ */
+void StatusModel::setStale(bool stale)
+{
+    if(m_bStale == stale)
+        return;
+    m_bStale = stale;
+    if(!m_items.isEmpty())
+        emit dataChanged(index(0), index(m_items.length() - 1), QVector<int>() << Qt::ForegroundRole << Qt::FontRole);
+}
+
+/**
+ * @param indexes Index du modèle
+ * @return Chemins des lignes désignées par @c indexes
+ */
+QStringList StatusModel::paths(const QModelIndexList& indexes) const
+{
+    QStringList result;
+    for(const QModelIndex& idx : indexes)
+    {
+        if(idx.isValid() && idx.row() < m_items.length())
+            result << m_items.at(idx.row()).path;
+    }
+    return result;
+}
+
+/**
+ * @param items Nouvelles lignes triées par chemin
+ *
+ * Remplace toutes les lignes par un changement de disposition : les index
+ * persistants sont déplacés vers la ligne de même chemin, ou invalidés si le
+ * chemin a disparu. La sélection de la vue est donc conservée par fichier.
+ */
+void StatusModel::rebuild(const QVector<StatusItem>& items)
+{
+    emit layoutAboutToBeChanged();
+    QModelIndexList from = persistentIndexList();
+    QStringList fromPaths;
+    fromPaths.reserve(from.length());
+    for(const QModelIndex& idx : from)
+    {
+        fromPaths << m_items.at(idx.row()).path;
+    }
+
+    m_items = items;
+    QHash<QString, int> rows;
+    rows.reserve(m_items.length());
+    for(int row = 0; row < m_items.length(); row++)
+    {
+        rows.insert(m_items.at(row).path, row);
+    }
+    QModelIndexList to;
+    to.reserve(from.length());
+    for(const QString& path : fromPaths)
+    {
+        int row = rows.value(path, -1);
+        to << (row == -1 ? QModelIndex() : index(row));
+    }
+    changePersistentIndexList(from, to);
+    emit layoutChanged();
+}
@@ -0,0 +1,245 @@
+#include "StatusParser.hpp"
+
+#include <cstring>
+
+/**
+ * Contructeur de la classe StatusParser.
+ */
+StatusParser::StatusParser()
+{
+    clear();
+}
+
+/**
+ * Efface le résultat de la dernière analyse.
+ */
+void StatusParser::clear()
+{
+    m_raw.clear();
+    m_entries.clear();
+    m_branchHead.clear();
+    m_branchOid.clear();
+    m_upstream.clear();
+    m_ahead = 0;
+    m_behind = 0;
+}
+
+/**
+ * @param raw Sortie brute de la commande @b git @b status @b --porcelain=v2 @b -z
+ * @return @c false si une entrée est mal formée, @c true sinon
+ *
+ * Analyse la sortie @c raw. Chaque entrée est terminée par un caractère nul.
+ * Pour les renommages (ligne @c 2), le chemin d'origine est l'entrée nulle
+ * suivante. Les entrées mal formées sont ignorées.
+ */
+bool StatusParser::parse(const QByteArray& raw)
+{
+    clear();
+    m_raw = raw;
+
+    const char* data = m_raw.constData();
+    const int size = m_raw.size();
+    bool bOk = true;
+    int pos = 0;
+
+    // Estimation grossière : une entrée fait rarement moins de 32 octets
+    m_entries.reserve(size / 32 + 1);
+
+    while(pos < size)
+    {
+        const char* found = static_cast<const char*>(std::memchr(data + pos, '\0', size - pos));
+        int end = found ? int(found - data) : size;
+
+        StatusEntry entry;
+        entry.fields = -1;
+        entry.orig = -1;
+        entry.origLength = 0;
+        entry.submodule = StatusEntry::NotSubmodule;
+        int pathPos = -1;
+
+        switch(data[pos])
+        {
+            case '#':
+                parseHeader(pos, end);
+                break;
+            case '1':
+                entry.kind = StatusEntry::Ordinary;
+                pathPos = skipFields(pos, end, 8);
+                break;
+            case '2':
+                entry.kind = StatusEntry::Renamed;
+                pathPos = skipFields(pos, end, 9);
+                break;
+            case 'u':
+                entry.kind = StatusEntry::Unmerged;
+                pathPos = skipFields(pos, end, 10);
+                break;
+            case '?':
+                entry.kind = StatusEntry::Untracked;
+                entry.x = entry.y = '?';
+                pathPos = pos + 2;
+                break;
+            case '!':
+                entry.kind = StatusEntry::Ignored;
+                entry.x = entry.y = '!';
+                pathPos = pos + 2;
+                break;
+            default:
+                bOk = false;
+                break;
+        }
+
+        if(data[pos] != '#' && pathPos != -1 && pathPos <= end)
+        {
+            if(entry.kind == StatusEntry::Ordinary ||
+               entry.kind == StatusEntry::Renamed ||
+               entry.kind == StatusEntry::Unmerged)
+            {
+                entry.x = data[pos + 2];
+                entry.y = data[pos + 3];
+                entry.fields = pos + 5;
+                entry.submodule = submoduleFlags(entry.fields);
+            }
+            entry.path = pathPos;
+            entry.pathLength = end - pathPos;
+
+            if(entry.kind == StatusEntry::Renamed && end < size)
+            {
+                // Chemin d'origine dans l'entrée suivante
+                int origPos = end + 1;
+                found = static_cast<const char*>(std::memchr(data + origPos, '\0', size - origPos));
+                end = found ? int(found - data) : size;
+                entry.orig = origPos;
+                entry.origLength = end - origPos;
+            }
+            m_entries.append(entry);
+        }
+        else if(data[pos] != '#')
+        {
+            bOk = false;
+        }
+
+        pos = end + 1;
+    }
+    return bOk;
+}
+
+/**
+ * @param entry Entrée à décoder
+ * @return Chemin de l'entrée
+ */
+QString StatusParser::path(const StatusEntry& entry) const
+{
+    return QString::fromUtf8(m_raw.constData() + entry.path, entry.pathLength);
+}
+
+/**
+ * @param entry Entrée à décoder
+ * @return Chemin d'origine d'un renommage, chaîne vide sinon
+ */
+QString StatusParser::origPath(const StatusEntry& entry) const
+{
+    if(entry.orig == -1)
+        return QString();
+    return QString::fromUtf8(m_raw.constData() + entry.orig, entry.origLength);
+}
+
+/**
+ * @param entry Entrée à décoder
+ * @return Chemin de l'entrée, sans copie
+ *
+ * Le tableau renvoyé référence directement la sortie brute : il n'est valide
+ * que tant que le StatusParser n'est ni modifié ni détruit.
+ */
+QByteArray StatusParser::rawPath(const StatusEntry& entry) const
+{
+    return QByteArray::fromRawData(m_raw.constData() + entry.path, entry.pathLength);
+}
+
+/**
+ * @param entry Entrée à décoder
+ * @param index Index du champ après XY (0 : sub, 1 : mH, ...)
+ * @return Champ demandé, sans copie, ou tableau vide s'il n'existe pas
+ *
+ * Permet de lire les modes et les identifiants d'objets d'une entrée. Comme
+ * pour StatusParser::rawPath, le tableau renvoyé référence la sortie brute.
+ */
+QByteArray StatusParser::field(const StatusEntry& entry, int index) const
+{
+    if(entry.fields == -1)
+        return QByteArray();
+
+    const char* data = m_raw.constData();
+    int start = skipFields(entry.fields, entry.path, index);
+    if(start == -1 || start >= entry.path)
+        return QByteArray();
+    int end = start;
+    while(end < entry.path && data[end] != ' ')
+        end++;
+    return QByteArray::fromRawData(data + start, end - start);
+}
+
+/**
+ * @param pos Position de départ
+ * @param end Position de fin de l'entrée
+ * @param count Nombre de champs à passer
+ * @return Position après le @c count ième espace, -1 si l'entrée est trop courte
+ */
+int StatusParser::skipFields(int pos, int end, int count) const
+{
+    const char* data = m_raw.constData();
+    while(count > 0)
+    {
+        const char* found = static_cast<const char*>(std::memchr(data + pos, ' ', end - pos));
+        if(!found)
+            return -1;
+        pos = int(found - data) + 1;
+        count--;
+    }
+    return pos;
+}
+
+/**
+ * @param pos Position du champ @c sub
+ * @return Combinaison de StatusEntry::SubmoduleFlag
+ *
+ * Le champ @c sub vaut @c N... pour un fichier et @c S<c><m><u> pour un
+ * sous-module.
+ */
+quint8 StatusParser::submoduleFlags(int pos) const
+{
+    const char* sub = m_raw.constData() + pos;
+    if(pos + 4 > m_raw.size() || sub[0] != 'S')
+        return StatusEntry::NotSubmodule;
+    quint8 flags = StatusEntry::Submodule;
+    if(sub[1] == 'C') flags |= StatusEntry::CommitChanged;
+    if(sub[2] == 'M') flags |= StatusEntry::TrackedChanges;
+    if(sub[3] == 'U') flags |= StatusEntry::UntrackedChanges;
+    return flags;
+}
+
+/**
+ * @param pos Position de l'en-tête
+ * @param end Position de fin de l'en-tête
+ *
+ * Analyse les en-têtes @c branch.* ajoutés par l'option @b --branch.
+ */
+void StatusParser::parseHeader(int pos, int end)
+{
+    const char* data = m_raw.constData();
+    int valuePos = skipFields(pos, end, 2);
+    if(valuePos == -1)
+        return;
+    QByteArray key = QByteArray::fromRawData(data + pos + 2, valuePos - pos - 3);
+    QByteArray value(data + valuePos, end - valuePos);
+
+    if(key == "branch.oid") m_branchOid = value;
+    else if(key == "branch.head") m_branchHead = QString::fromUtf8(value);
+    else if(key == "branch.upstream") m_upstream = QString::fromUtf8(value);
+    else if(key == "branch.ab")
+    {
+        int sep = value.indexOf(' ');
+        m_ahead = value.mid(1, sep - 1).toInt();
+        m_behind = value.mid(sep + 2).toInt();
+    }
+}
@@ -0,0 +1,162 @@
+#include "Tracer.hpp"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+/**
+ * @param p Rang (entre 0 et 1)
+ * @return Borne supérieure de la classe contenant ce rang (ns)
+ */
+qint64 TracePhase::percentile(double p) const
+{
+    quint64 rank = quint64(p * count);
+    quint64 seen = 0;
+    for(int i = 0; i < TRACE_BUCKETS; i++)
+    {
+        seen += buckets[i];
+        if(seen > rank)
+            return qMin(max, (qint64(1) << i) * 1000);
+    }
+    return max;
+}
+
+Tracer::Tracer() :
+    m_next(0)
+{
+    m_clock.start();
+}
+
+Tracer* Tracer::Instance()
+{
+    // Initialisation garantie unique même si plusieurs threads l'appellent
+    static Tracer* instance = new Tracer();
+    return instance;
+}
+
+/**
+ * @param name Nom de la phase (chaîne statique)
+ * @param start Début de la phase (voir Tracer::now)
+ * @param end Fin de la phase (voir Tracer::now)
+ * @param detail Précision facultative
+ *
+ * Ajoute la durée à l'histogramme de la phase et conserve l'événement pour
+ * l'export.
+ */
+void Tracer::record(const char* name, qint64 start, qint64 end, const QString& detail)
+{
+    qint64 duration = qMax(qint64(0), end - start);
+    int bucket = 0;
+    for(qint64 us = duration / 1000; us > 0 && bucket < TRACE_BUCKETS - 1; us >>= 1)
+    {
+        bucket++;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    // Recherche sans copie du nom
+    QHash<QByteArray, TracePhase>::iterator it = m_phases.find(QByteArray::fromRawData(name, int(qstrlen(name))));
+    if(it == m_phases.end())
+        it = m_phases.insert(QByteArray(name), TracePhase());
+    TracePhase& phase = it.value();
+    phase.count++;
+    phase.total += duration;
+    phase.max = qMax(phase.max, duration);
+    phase.buckets[bucket]++;
+
+    if(m_events.size() < TRACE_MAX_EVENTS)
+        m_events.append(TraceEvent());
+    TraceEvent& event = m_events[m_next];
+    m_next = (m_next + 1) % TRACE_MAX_EVENTS;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.thread = quint64(quintptr(QThread::currentThreadId()));
+    event.detail = detail;
+}
+
+/**
+ * @return Copie des histogrammes de toutes les phases
+ */
+QHash<QByteArray, TracePhase> Tracer::phases() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_phases;
+}
+
+/**
+ * Efface les événements et les histogrammes.
+ */
+void Tracer::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_events.clear();
+    m_next = 0;
+    m_phases.clear();
+}
+
+/**
+ * @param fileName Fichier JSON à écrire
+ * @return @c false si le fichier n'a pas pu être écrit
+ *
+ * Ecrit les événements conservés au format "trace event" de Chrome : un
+ * événement complet (@c ph @c X) par phase mesurée, le nom de la phase avant
+ * le @c / servant de catégorie. Les histogrammes sont ajoutés dans l'objet
+ * @c phases (durées en microsecondes).
+ */
+bool Tracer::exportChromeTrace(const QString& fileName) const
+{
+    QJsonArray events;
+    QJsonObject phases;
+    {
+        QMutexLocker lock(&m_mutex);
+        // Ordre chronologique : le tampon a pu reboucler
+        int first = m_events.size() < TRACE_MAX_EVENTS ? 0 : m_next;
+        for(int i = 0; i < m_events.size(); i++)
+        {
+            const TraceEvent& event = m_events.at((first + i) % m_events.size());
+            QString name = QString::fromLatin1(event.name);
+            QJsonObject item;
+            item["name"] = name;
+            item["cat"] = name.section('/', 0, 0);
+            item["ph"] = "X";
+            item["ts"] = double(event.start) / 1000;
+            item["dur"] = double(event.duration) / 1000;
+            item["pid"] = qint64(QCoreApplication::applicationPid());
+            item["tid"] = double(event.thread);
+            if(!event.detail.isEmpty())
+                item["args"] = QJsonObject{{"detail", event.detail}};
+            events.append(item);
+        }
+
+        for(QHash<QByteArray, TracePhase>::const_iterator it = m_phases.constBegin(); it != m_phases.constEnd(); ++it)
+        {
+            const TracePhase& phase = it.value();
+            QJsonObject item;
+            item["count"] = double(phase.count);
+            item["total_us"] = double(phase.total) / 1000;
+            item["max_us"] = double(phase.max) / 1000;
+            item["p50_us"] = double(phase.percentile(0.5)) / 1000;
+            item["p95_us"] = double(phase.percentile(0.95)) / 1000;
+            QJsonArray buckets;
+            for(int i = 0; i < TRACE_BUCKETS; i++)
+            {
+                buckets.append(double(phase.buckets[i]));
+            }
+            item["buckets"] = buckets;
+            phases[QString::fromLatin1(it.key())] = item;
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    root["phases"] = phases;
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
@@ -0,0 +1,215 @@
+#include "Workspace.hpp"
+
+#include <QDir>
+#include "GitExecutor.hpp"
+#include "Logger.hpp"
+#include "StatusParser.hpp"
+
+/**
+ * @param parent Objet parent
+ *
+ * Contructeur de la classe Workspace.@n
+ * Démarre le rafraîchissement périodique des dépôts.
+ */
+Workspace::Workspace(QObject* parent) :
+    QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &Workspace::refreshAll);
+    m_timer.start(WORKSPACE_REFRESH_S * 1000);
+}
+
+/**
+ * @param path Dossier
+ * @return Chemin absolu normalisé du dossier
+ */
+QString Workspace::normalize(const QString& path)
+{
+    return QDir::cleanPath(QDir(path).absolutePath());
+}
+
+/**
+ * @param paths Dossiers des dépôts
+ *
+ * Remplace la liste des dépôts et lance leur rafraîchissement.
+ */
+void Workspace::setRepositories(const QStringList& paths)
+{
+    m_repos.clear();
+    for(const QString& path : paths)
+    {
+        if(indexOf(path) == -1)
+        {
+            RepoSummary summary;
+            summary.path = normalize(path);
+            m_repos.append(summary);
+        }
+    }
+    emit changed();
+    refreshAll();
+}
+
+/**
+ * @return Dossiers des dépôts
+ */
+QStringList Workspace::repositories() const
+{
+    QStringList paths;
+    for(const RepoSummary& summary : m_repos)
+    {
+        paths << summary.path;
+    }
+    return paths;
+}
+
+/**
+ * @param path Dossier du dépôt
+ * @return @c false si le dépôt est déjà suivi
+ */
+bool Workspace::add(const QString& path)
+{
+    if(indexOf(path) != -1)
+        return false;
+    RepoSummary summary;
+    summary.path = normalize(path);
+    m_repos.append(summary);
+    qLog->info("Espace de travail : ajout de", summary.path);
+    emit changed();
+    refresh(m_repos.length() - 1);
+    return true;
+}
+
+/**
+ * @param path Dossier du dépôt
+ */
+void Workspace::remove(const QString& path)
+{
+    int index = indexOf(path);
+    if(index == -1)
+        return;
+    qLog->info("Espace de travail : retrait de", m_repos.at(index).path);
+    m_repos.remove(index);
+    emit changed();
+}
+
+/**
+ * @param path Dossier du dépôt
+ * @return Position du dépôt, -1 s'il n'est pas suivi
+ */
+int Workspace::indexOf(const QString& path) const
+{
+    const QString normalized = normalize(path);
+    for(int i = 0; i < m_repos.length(); i++)
+    {
+        if(m_repos.at(i).path == normalized)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @param path Dossier du dépôt affiché par la fenêtre principale
+ */
+void Workspace::setForeground(const QString& path)
+{
+    m_foreground = normalize(path);
+    emit changed();
+}
+
+/**
+ * @param path Dossier du dépôt
+ * @param parser Résultat du status du dépôt, avec l'option @c --branch
+ * @param untracked Nombre de fichiers non suivis, si le status a été exécuté
+ * sans eux (option @c -uno), -1 sinon
+ *
+ * Met à jour le résumé d'un dépôt à partir d'un status déjà exécuté.
+ */
+void Workspace::setSummary(const QString& path, const StatusParser& parser, int untracked /*= -1*/)
+{
+    int index = indexOf(path);
+    if(index == -1)
+        return;
+    summarize(m_repos[index], parser);
+    if(untracked >= 0)
+        m_repos[index].untracked = untracked;
+    emit updated(index);
+}
+
+/**
+ * Lance le status de chaque dépôt, sauf celui au premier plan et ceux dont le
+ * status est déjà en cours.
+ */
+void Workspace::refreshAll()
+{
+    for(int i = 0; i < m_repos.length(); i++)
+    {
+        if(!m_repos.at(i).pending && m_repos.at(i).path != m_foreground)
+            refresh(i);
+    }
+}
+
+/**
+ * @param index Position du dépôt
+ *
+ * Lance le status du dépôt en basse priorité.
+ */
+void Workspace::refresh(int index)
+{
+    RepoSummary& summary = m_repos[index];
+    summary.pending = true;
+    const QString path = summary.path;
+    GitJob* job = qGit->background(path, QStringList() << "status" << "--porcelain=v2" << "--branch" << "-z");
+    connect(job, &GitJob::finished, this, [this, path](const GitResult& result) {
+        // Le dépôt a pu être retiré ou déplacé pendant le status
+        int index = indexOf(path);
+        if(index == -1)
+            return;
+        RepoSummary& summary = m_repos[index];
+        summary.pending = false;
+        if(result.success())
+        {
+            StatusParser parser;
+            parser.parse(result.output);
+            summarize(summary, parser);
+        }
+        else
+        {
+            summary.valid = false;
+            summary.error = result.errorText().trimmed();
+            summary.updated = QDateTime::currentDateTime();
+        }
+        emit updated(index);
+    });
+}
+
+/**
+ * @param summary Résumé à mettre à jour
+ * @param parser Résultat du status du dépôt
+ */
+void Workspace::summarize(RepoSummary& summary, const StatusParser& parser)
+{
+    summary.branch = parser.branchHead() == "(detached)" ? QString() : parser.branchHead();
+    summary.staged = 0;
+    summary.unstaged = 0;
+    summary.untracked = 0;
+    summary.conflicts = 0;
+    for(const StatusEntry& entry : parser.entries())
+    {
+        if(entry.kind == StatusEntry::Unmerged)
+            summary.conflicts++;
+        else if(entry.kind == StatusEntry::Untracked)
+            summary.untracked++;
+        else
+        {
+            if(entry.isStaged())
+                summary.staged++;
+            if(entry.isUnstaged())
+                summary.unstaged++;
+        }
+    }
+    summary.hasUpstream = !parser.branchUpstream().isEmpty();
+    summary.ahead = parser.ahead();
+    summary.behind = parser.behind();
+    summary.valid = true;
+    summary.error.clear();
+    summary.updated = QDateTime::currentDateTime();
+}